@@ -0,0 +1,48 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE
+#include <affinity.h>
+#include <sched.h>
+#include <stdlib.h>
+
+int parseCpuList(const char *text, cpu_list_t *list) {
+    list->count = 0;
+    const char *p = text;
+    while (*p) {
+        char *end;
+        long from = strtol(p, &end, 10);
+        if (end == p || from < 0) return -1;
+        long to = from;
+        p = end;
+        if (*p == '-') {
+            to = strtol(p + 1, &end, 10);
+            if (end == p + 1 || to < from) return -1;
+            p = end;
+        }
+        for (long cpu = from; cpu <= to; cpu++) {
+            if (list->count == MAX_CPU_LIST || cpu >= CPU_SETSIZE) return -1;
+            list->cpus[list->count++] = (int)cpu;
+        }
+        if (*p == ',') p++;
+        else if (*p) return -1;
+    }
+    return list->count > 0 ? 0 : -1;
+}
+
+int pinToCpuList(const cpu_list_t *list) {
+    if (list->count == 0) return 0;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int i = 0; i < list->count; i++) {
+        CPU_SET(list->cpus[i], &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set);
+}
+
+int pinToCpuSlot(const cpu_list_t *list, int index) {
+    if (list->count == 0) return 0;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(list->cpus[index % list->count], &set);
+    return sched_setaffinity(0, sizeof(set), &set);
+}
@@ -0,0 +1,294 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file bench.c
+ * @brief Microbenchmarks de las funciones críticas de ChompChamps
+ *
+ * Mide playerlib, la lógica del máster, el orden de jugadores y el dibujado
+ * del tablero sobre varios tamaños de tablero y cantidades de jugadores, más
+ * una corrida completa de partidas en modo lockstep. Todas las semillas son
+ * fijas y la salida es CSV, para poder comparar contra una línea de base.
+ *
+ * Se ejecuta desde el directorio de compilación (make bench), ya que lanza
+ * ./master y los binarios de players/.
+ *
+ * @author Grupo 21
+ * @date 2025
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <playerlib.h>
+#include <chambers.h>
+#include <score.h>
+#include <game.h>
+#include <render.h>
+
+#define BENCH_SEED 42
+#define BENCH_MIN_NS 50000000LL   // Tiempo mínimo medido por kernel (50 ms)
+#define BENCH_GAMES 5             // Partidas por corrida completa
+#define BFS_BENCH_DEPTH 10
+
+static const int boardSizes[] = {10, 50, 100};
+static const int playerCounts[] = {2, 4, 9};
+static const char *playerBinaries[] = {
+    "players/planner", "players/cautious", "players/hermit",
+    "players/greedy", "players/chaser", "players/panzer",
+    "players/enforcer", "players/opportunist", "players/strategist"
+};
+
+#define COUNT(arr) ((int)(sizeof(arr) / sizeof((arr)[0])))
+
+typedef long long (*kernel_fn)(game_state_t *state, long long iterations);
+
+static long long nowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Arma un tablero y posiciones deterministas sin memoria compartida
+static void setupState(game_state_t *state, int size, int players) {
+    memset(state, 0, sizeof(*state));
+    state->width = size;
+    state->height = size;
+    state->num_jugadores = players;
+    generateBoard(state, BENCH_SEED);
+    initNeighborTables(state);
+    setStartingPositions(state, BENCH_SEED);
+    for (int i = 0; i < players; i++) {
+        snprintf(state->jugadores[i].nombre, PLAYER_NAME_LENGTH, "bench%d", i);
+        state->jugadores[i].puntaje = boardRandom(BENCH_SEED, i) % 500;
+        state->jugadores[i].validRequests = boardRandom(BENCH_SEED + 1, i) % 100;
+        state->jugadores[i].pid = i + 1;
+    }
+    initRanking(state);
+}
+
+static long long benchBfsExplore(game_state_t *state, long long iterations) {
+    volatile int sink = 0;
+    for (long long i = 0; i < iterations; i++) {
+        int explored;
+        sink += bfsExplore(state, state->width / 2, state->height / 2, BFS_BENCH_DEPTH, &explored);
+    }
+    return iterations;
+}
+
+static long long benchChamberFrom(game_state_t *state, long long iterations) {
+    static chamber_analyzer_t *analyzer = NULL;
+    if (!analyzer) analyzer = createChamberAnalyzer();
+    volatile int sink = 0;
+    for (long long i = 0; i < iterations; i++) {
+        chamber_info_t info;
+        chamberFrom(analyzer, state, state->width / 2, state->height / 2, &info);
+        sink += info.cells;
+    }
+    return iterations;
+}
+
+static long long benchAnalyzeMoves(game_state_t *state, long long iterations) {
+    static chamber_analyzer_t *analyzer = NULL;
+    if (!analyzer) analyzer = createChamberAnalyzer();
+    volatile int sink = 0;
+    for (long long i = 0; i < iterations; i++) {
+        chamber_info_t info[8];
+        analyzeMoves(analyzer, state, state->width / 2, state->height / 2, info);
+        sink += info[0].cells;
+    }
+    return iterations;
+}
+
+static long long benchFreeNeighborCount(game_state_t *state, long long iterations) {
+    volatile int sink = 0;
+    for (long long i = 0; i < iterations; i++) {
+        for (int y = 0; y < state->height; y++) {
+            for (int x = 0; x < state->width; x++) {
+                sink += freeNeighborCount(state, x, y);
+            }
+        }
+    }
+    return iterations * state->width * state->height;
+}
+
+static long long benchSqrDistClosestOther(game_state_t *state, long long iterations) {
+    volatile int sink = 0;
+    for (long long i = 0; i < iterations; i++) {
+        for (int y = 0; y < state->height; y++) {
+            for (int x = 0; x < state->width; x++) {
+                sink += sqrDistClosestOther(state, 0, x, y);
+            }
+        }
+    }
+    return iterations * state->width * state->height;
+}
+
+static long long benchGetPlayerOrder(game_state_t *state, long long iterations) {
+    for (long long i = 0; i < iterations; i++) {
+        free(getPlayerOrder(state));
+    }
+    return iterations;
+}
+
+// Suma puntos a jugadores rotativos, como hace el máster con cada movimiento válido
+static long long benchUpdateRanking(game_state_t *state, long long iterations) {
+    for (long long i = 0; i < iterations; i++) {
+        int id = i % state->num_jugadores;
+        state->jugadores[id].puntaje += boardRandom(BENCH_SEED, i) % 10;
+        state->jugadores[id].validRequests++;
+        updateRanking(state, id);
+    }
+    return iterations;
+}
+
+static long long benchDrawBoard(game_state_t *state, long long iterations) {
+    for (long long i = 0; i < iterations; i++) {
+        drawBoard(state);
+    }
+    fflush(stdout);
+    return iterations;
+}
+
+// Copia solo las celdas en uso para que restaurar no domine la medición en tableros chicos
+static void copyBoard(game_state_t *dst, const game_state_t *src) {
+    size_t cells = (size_t)src->width * src->height;
+    memcpy(dst->jugadores, src->jugadores, sizeof(src->jugadores));
+    memcpy(dst->tablero, src->tablero, cells * sizeof(src->tablero[0]));
+    memcpy(dst->free_neighbors, src->free_neighbors, cells);
+    memcpy(dst->legal_moves, src->legal_moves, cells);
+    memcpy(dst->tile_free_value, src->tile_free_value, sizeof(src->tile_free_value));
+    memcpy(dst->tile_owned, src->tile_owned, sizeof(src->tile_owned));
+}
+
+// Recorre el tablero con el jugador 0 hasta atascarlo, eligiendo direcciones legales
+static long long benchMovePlayer(game_state_t *state, long long iterations) {
+    static game_state_t initial;
+    initial.width = state->width;
+    initial.height = state->height;
+    copyBoard(&initial, state);
+    long long moves = 0;
+
+    for (long long i = 0; i < iterations; i++) {
+        copyBoard(state, &initial);
+        uint64_t counter = i * state->width * state->height;
+        while (!isStuck(state, 0)) {
+            jugador_t *player = &state->jugadores[0];
+            unsigned char legal = state->legal_moves[player->y * state->width + player->x];
+            int dir = boardRandom(BENCH_SEED, counter++) % 8;
+            while (!(legal & (1 << dir))) dir = (dir + 1) % 8;
+
+            movePlayer(state, 0, player->x + dirX[dir], player->y + dirY[dir]);
+            moves++;
+        }
+    }
+    copyBoard(state, &initial);
+    return moves;
+}
+
+static void report(FILE *out, const char *kernel, int size, int players, long long ops, long long elapsed) {
+    fprintf(out, "%s,%d,%d,%d,%lld,%.1f\n", kernel, size, size, players, ops, (double)elapsed / ops);
+    fflush(out);
+}
+
+// Duplica las iteraciones hasta superar BENCH_MIN_NS para que la medición sea estable
+static void runKernel(FILE *out, const char *kernel, kernel_fn fn, game_state_t *state, int size, int players) {
+    long long iterations = 1;
+    for (;;) {
+        long long start = nowNs();
+        long long ops = fn(state, iterations);
+        long long elapsed = nowNs() - start;
+        if (elapsed >= BENCH_MIN_NS) {
+            report(out, kernel, size, players, ops, elapsed);
+            return;
+        }
+        iterations *= 2;
+    }
+}
+
+// Corre BENCH_GAMES partidas lockstep con el binario del máster y mide el total
+static void runGames(FILE *out, int size, int players) {
+    char sizeArg[16], gamesArg[16], seedArg[16];
+    snprintf(sizeArg, sizeof(sizeArg), "%d", size);
+    snprintf(gamesArg, sizeof(gamesArg), "%d", BENCH_GAMES);
+    snprintf(seedArg, sizeof(seedArg), "%d", BENCH_SEED);
+
+    char *argv[16 + MAX_JUGADORES];
+    int argc = 0;
+    argv[argc++] = "master";
+    argv[argc++] = "-l";
+    argv[argc++] = "-w"; argv[argc++] = sizeArg;
+    argv[argc++] = "-h"; argv[argc++] = sizeArg;
+    argv[argc++] = "-g"; argv[argc++] = gamesArg;
+    argv[argc++] = "-s"; argv[argc++] = seedArg;
+    argv[argc++] = "-p";
+    for (int i = 0; i < players; i++) {
+        argv[argc++] = (char *)playerBinaries[i % COUNT(playerBinaries)];
+    }
+    argv[argc] = NULL;
+
+    long long start = nowNs();
+    pid_t pid = fork();
+    if (pid == 0) {
+        execv("./master", argv);
+        perror("execv master");
+        _exit(1);
+    }
+    int status;
+    if (pid < 0 || waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "bench: falló la corrida de partidas (%dx%d, %d jugadores)\n", size, size, players);
+        return;
+    }
+    report(out, "games", size, players, BENCH_GAMES, nowNs() - start);
+}
+
+int main() {
+    // Los resultados van al stdout original; todo lo demás se descarta
+    fflush(stdout);
+    FILE *out = fdopen(dup(STDOUT_FILENO), "w");
+    int devnull = open("/dev/null", O_WRONLY);
+    if (!out || devnull < 0) {
+        perror("bench");
+        return 1;
+    }
+    dup2(devnull, STDOUT_FILENO);
+    close(devnull);
+
+    game_state_t *state = malloc(sizeof(game_state_t));
+    if (!state) {
+        perror("malloc");
+        return 1;
+    }
+
+    fprintf(out, "kernel,width,height,players,ops,ns_per_op\n");
+    for (int s = 0; s < COUNT(boardSizes); s++) {
+        int size = boardSizes[s];
+
+        setupState(state, size, 2);
+        runKernel(out, "bfsExplore", benchBfsExplore, state, size, 2);
+        runKernel(out, "chamberFrom", benchChamberFrom, state, size, 2);
+        runKernel(out, "analyzeMoves", benchAnalyzeMoves, state, size, 2);
+        runKernel(out, "freeNeighborCount", benchFreeNeighborCount, state, size, 2);
+        runKernel(out, "movePlayer+isStuck", benchMovePlayer, state, size, 2);
+
+        for (int p = 0; p < COUNT(playerCounts); p++) {
+            int players = playerCounts[p];
+            setupState(state, size, players);
+            runKernel(out, "sqrDistClosestOther", benchSqrDistClosestOther, state, size, players);
+            runKernel(out, "getPlayerOrder", benchGetPlayerOrder, state, size, players);
+            runKernel(out, "updateRanking", benchUpdateRanking, state, size, players);
+            setupState(state, size, players);
+            runKernel(out, "drawBoard", benchDrawBoard, state, size, players);
+            runGames(out, size, players);
+        }
+    }
+
+    free(state);
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,165 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _DEFAULT_SOURCE
+#include <boardfile.h>
+#include <game.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Registro más grande posible, para armar la exportación sin memoria dinámica
+static unsigned char exportRecord[sizeof(board_positions_t) + MAX_WIDTH * MAX_HEIGHT + 3];
+
+// Tamaño de un registro, redondeado para que los siguientes queden alineados
+static unsigned int recordSize(unsigned int width, unsigned int height) {
+    return (sizeof(board_positions_t) + width * height + 3) & ~3u;
+}
+
+static const unsigned char *recordAt(const board_file_t *file, unsigned int index) {
+    return (const unsigned char *)(file->header + 1) + (size_t)index * file->header->record_size;
+}
+
+// Valida un registro: valores entre 1 y 9 y posiciones distintas dentro del tablero
+static int checkRecord(const board_file_header_t *header, const unsigned char *record, unsigned int players) {
+    const board_positions_t *positions = (const board_positions_t *)record;
+    const unsigned char *cells = record + sizeof(board_positions_t);
+    for (size_t i = 0; i < (size_t)header->width * header->height; i++) {
+        if (cells[i] < 1 || cells[i] > 9) return -1;
+    }
+    for (unsigned int i = 0; i < players; i++) {
+        if (positions->x[i] >= header->width || positions->y[i] >= header->height) return -1;
+        for (unsigned int j = 0; j < i; j++) {
+            if (positions->x[i] == positions->x[j] && positions->y[i] == positions->y[j]) return -1;
+        }
+    }
+    return 0;
+}
+
+int openBoardFile(board_file_t *file, const char *path, unsigned int players) {
+    file->header = NULL;
+    file->size = 0;
+    file->fd = open(path, O_RDONLY);
+    if (file->fd == -1) return -1;
+
+    // El lock compartido espera a que termine cualquier exportación en curso
+    flock(file->fd, LOCK_SH);
+    struct stat st;
+    int error = 0;
+    if (fstat(file->fd, &st) == -1) {
+        error = errno;
+    } else if ((size_t)st.st_size < sizeof(board_file_header_t)) {
+        error = EINVAL;
+    } else {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, file->fd, 0);
+        if (data == MAP_FAILED) {
+            error = errno;
+        } else {
+            file->header = data;
+            file->size = st.st_size;
+        }
+    }
+    flock(file->fd, LOCK_UN);
+
+    const board_file_header_t *header = file->header;
+    if (!error && (header->magic != BOARD_FILE_MAGIC || header->version != BOARD_FILE_VERSION
+                   || header->width < 1 || header->width > MAX_WIDTH
+                   || header->height < 1 || header->height > MAX_HEIGHT
+                   || header->positions > MAX_JUGADORES || header->positions < players || header->count == 0
+                   || header->record_size != recordSize(header->width, header->height)
+                   || file->size < sizeof(*header) + (size_t)header->count * header->record_size)) {
+        error = EINVAL;
+    }
+    for (unsigned int i = 0; !error && i < header->count; i++) {
+        if (checkRecord(header, recordAt(file, i), players) != 0) error = EINVAL;
+    }
+
+    if (error) {
+        closeBoardFile(file);
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+void loadBoard(const board_file_t *file, unsigned int index, game_state_t *state) {
+    const unsigned char *record = recordAt(file, index % file->header->count);
+    const board_positions_t *positions = (const board_positions_t *)record;
+    const unsigned char *cells = record + sizeof(board_positions_t);
+
+    state->width = file->header->width;
+    state->height = file->header->height;
+    for (size_t i = 0; i < (size_t)state->width * state->height; i++) {
+        state->tablero[i] = cells[i];
+    }
+    initNeighborTables(state);
+    for (size_t i = 0; i < state->num_jugadores; i++) {
+        movePlayer(state, i, positions->x[i], positions->y[i]);
+    }
+}
+
+void closeBoardFile(board_file_t *file) {
+    if (file->header != NULL) {
+        munmap((void *)file->header, file->size);
+        file->header = NULL;
+    }
+    if (file->fd != -1) {
+        close(file->fd);
+        file->fd = -1;
+    }
+}
+
+int appendBoard(int fd, const game_state_t *state) {
+    if (flock(fd, LOCK_EX) == -1) return -1;
+
+    board_file_header_t header;
+    struct stat st;
+    int error = 0;
+    if (fstat(fd, &st) == -1) {
+        error = errno;
+    } else if (st.st_size == 0) {
+        header = (board_file_header_t){BOARD_FILE_MAGIC, BOARD_FILE_VERSION, state->width, state->height,
+                                       state->num_jugadores, 0, recordSize(state->width, state->height)};
+    } else if (pread(fd, &header, sizeof(header), 0) != sizeof(header)) {
+        error = EINVAL;
+    } else if (header.magic != BOARD_FILE_MAGIC || header.version != BOARD_FILE_VERSION
+               || header.width != state->width || header.height != state->height
+               || header.positions != state->num_jugadores) {
+        error = EINVAL;
+    }
+
+    if (!error) {
+        size_t cells = (size_t)state->width * state->height;
+        board_positions_t *positions = (board_positions_t *)exportRecord;
+        memset(exportRecord, 0, header.record_size);
+        for (size_t i = 0; i < state->num_jugadores; i++) {
+            positions->x[i] = state->jugadores[i].x;
+            positions->y[i] = state->jugadores[i].y;
+        }
+        for (size_t i = 0; i < cells; i++) {
+            int val = state->tablero[i];
+            exportRecord[sizeof(board_positions_t) + i] = val > 0 ? val : 1;
+        }
+
+        // Primero el registro y después el contador, así un lector nunca ve un tablero a medias
+        off_t offset = sizeof(header) + (off_t)header.count * header.record_size;
+        ssize_t written = pwrite(fd, exportRecord, header.record_size, offset);
+        if (written == (ssize_t)header.record_size) {
+            header.count++;
+            written = pwrite(fd, &header, sizeof(header), 0);
+            if (written != sizeof(header)) error = written == -1 ? errno : EIO;
+        } else {
+            error = written == -1 ? errno : EIO;
+        }
+    }
+
+    flock(fd, LOCK_UN);
+    if (error) {
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,263 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _DEFAULT_SOURCE
+#include <chambers.h>
+#include <game.h>
+#include <string.h>
+
+#define CELLS (MAX_WIDTH * MAX_HEIGHT)
+
+// Celdas y recompensa de un tramo recorrible
+typedef struct {
+    int cells;
+    int value;
+} span_t;
+
+// Bloque biconexo de una región, visto desde la raíz del recorrido
+typedef struct {
+    int head;           // Articulación por la que cuelga del resto (o la raíz)
+    span_t members;     // Celdas del bloque sin la cabeza
+    span_t down;        // Mejor recorrido entrando desde la cabeza
+    span_t up;          // Mejor recorrido saliendo por la cabeza sin volver al bloque
+    span_t best[2];     // Los dos mejores bolsillos que cuelgan de los miembros
+    int bestMember;     // Miembro del que cuelga best[0]
+} block_t;
+
+// Las marcas por generación evitan limpiar los arreglos en cada análisis
+struct chamber_analyzer {
+    unsigned int generation;
+    unsigned short width;
+    unsigned int visited[CELLS];
+    unsigned int articulation[CELLS];
+    int disc[CELLS];
+    int low[CELLS];
+    int parent[CELLS];
+    unsigned char nextDir[CELLS];
+    span_t body[CELLS];     // Parte del subárbol que queda en la cámara del nodo
+    span_t pocket[CELLS];   // Mejor bolsillo colgando del subárbol
+    int stack[CELLS];
+    int order[CELLS];       // Celdas en orden de descubrimiento
+    int blockOf[CELLS];     // Bloque de la arista que une a cada celda con su padre
+    span_t hang[CELLS][2];  // Los dos mejores bloques que cuelgan de cada celda
+    int hangBlock[CELLS];   // Bloque de hang[v][0]
+    block_t blocks[CELLS];
+};
+
+chamber_analyzer_t *createChamberAnalyzer(void) {
+    return calloc(1, sizeof(chamber_analyzer_t));
+}
+
+static int beats(span_t b, span_t a) {
+    return b.cells > a.cells || (b.cells == a.cells && b.value > a.value);
+}
+
+// Se prefiere el tramo con más celdas; a igualdad, el de más recompensa
+static span_t better(span_t a, span_t b) {
+    return beats(b, a) ? b : a;
+}
+
+static span_t join(span_t a, span_t b) {
+    return (span_t){a.cells + b.cells, a.value + b.value};
+}
+
+// Mantiene los dos mejores tramos y de quién es el primero, para poder excluirlo
+static void keepTop(span_t top[2], int *owner, span_t candidate, int id) {
+    if (beats(candidate, top[0])) {
+        top[1] = top[0];
+        top[0] = candidate;
+        *owner = id;
+    } else if (beats(candidate, top[1])) {
+        top[1] = candidate;
+    }
+}
+
+static span_t topExcept(const span_t top[2], int owner, int id) {
+    return owner == id ? top[1] : top[0];
+}
+
+static unsigned int nextGeneration(chamber_analyzer_t *a) {
+    if (++a->generation == 0) {
+        memset(a->visited, 0, sizeof(a->visited));
+        memset(a->articulation, 0, sizeof(a->articulation));
+        a->generation = 1;
+    }
+    return a->generation;
+}
+
+// Tarjan desde una celda libre no visitada en esta generación. Deja el
+// resultado de entrar por root en info y devuelve las celdas alcanzadas,
+// que quedan en a->order en orden de descubrimiento.
+static int explore(chamber_analyzer_t *a, game_state_t *state, int root, unsigned int gen, chamber_info_t *info) {
+    int width = state->width;
+    memset(info, 0, sizeof(*info));
+
+    int time = 0, top = 0, rootChildren = 0;
+    a->visited[root] = gen;
+    a->disc[root] = a->low[root] = time;
+    a->order[time++] = root;
+    a->parent[root] = -1;
+    a->nextDir[root] = 0;
+    a->body[root] = (span_t){1, state->tablero[root]};
+    a->pocket[root] = (span_t){0, 0};
+    a->stack[top++] = root;
+
+    while (top > 0) {
+        int v = a->stack[top - 1];
+        if (a->nextDir[v] < 8) {
+            int d = a->nextDir[v]++;
+            if (!(state->legal_moves[v] & (1 << d))) continue;
+            int w = v + dirY[d] * width + dirX[d];
+
+            if (a->visited[w] != gen) {
+                a->visited[w] = gen;
+                a->disc[w] = a->low[w] = time;
+                a->order[time++] = w;
+                a->parent[w] = v;
+                a->nextDir[w] = 0;
+                a->body[w] = (span_t){1, state->tablero[w]};
+                a->pocket[w] = (span_t){0, 0};
+                a->stack[top++] = w;
+            } else if (w != a->parent[v] && a->disc[w] < a->low[v]) {
+                a->low[v] = a->disc[w];
+            }
+            continue;
+        }
+
+        top--;
+        int p = a->parent[v];
+        if (p < 0) continue;
+        if (a->low[v] < a->low[p]) a->low[p] = a->low[v];
+
+        if (a->low[v] >= a->disc[p]) {
+            // p separa al subárbol de v: entrar ahí es un bolsillo sin vuelta
+            if (p == root) {
+                rootChildren++;
+            } else if (a->articulation[p] != gen) {
+                a->articulation[p] = gen;
+                info->articulations++;
+            }
+            a->pocket[p] = better(a->pocket[p], join(a->body[v], a->pocket[v]));
+        } else {
+            a->body[p] = join(a->body[p], a->body[v]);
+            a->pocket[p] = better(a->pocket[p], a->pocket[v]);
+        }
+    }
+
+    if (rootChildren > 1) {
+        a->articulation[root] = gen;
+        info->articulations++;
+    }
+    info->cells = a->body[root].cells + a->pocket[root].cells;
+    info->value = a->body[root].value + a->pocket[root].value;
+    info->reachable = time;
+    return time;
+}
+
+// Mejor recorrido entrando al bloque por un miembro x que no es su cabeza:
+// el bloque entero y después un bolsillo de otro miembro o la salida por la cabeza
+static span_t enterBlock(const chamber_analyzer_t *a, game_state_t *state, int id, int x) {
+    const block_t *b = &a->blocks[id];
+    span_t own = {b->members.cells, b->members.value + state->tablero[b->head] - state->tablero[x]};
+    return join(own, better(topExcept(b->best, b->bestMember, x), b->up));
+}
+
+// Arma el árbol de bloques de la región que dejó explore, con los mejores
+// recorridos hacia abajo y hacia arriba de cada bloque, para poder responder
+// desde cualquier celda de la región como si el recorrido hubiera empezado ahí
+static void buildBlocks(chamber_analyzer_t *a, game_state_t *state, int count) {
+    int root = a->order[0];
+    int blocks = 0;
+    for (int i = 0; i < count; i++) {
+        int v = a->order[i];
+        a->hang[v][0] = a->hang[v][1] = (span_t){0, 0};
+        a->hangBlock[v] = -1;
+        if (i == 0) continue;
+        // Un hijo separado de su padre abre un bloque con el padre como cabeza
+        int p = a->parent[v];
+        if (a->low[v] >= a->disc[p]) {
+            a->blocks[blocks] = (block_t){p, {0, 0}, {0, 0}, {0, 0}, {{0, 0}, {0, 0}}, -1};
+            a->blockOf[v] = blocks++;
+        } else {
+            a->blockOf[v] = a->blockOf[p];
+        }
+    }
+
+    // En orden inverso cada celda llega después de todo su subárbol, así que
+    // el primer miembro de un bloque cierra el bloque
+    for (int i = count - 1; i > 0; i--) {
+        int v = a->order[i];
+        int id = a->blockOf[v];
+        block_t *b = &a->blocks[id];
+        b->members = join(b->members, (span_t){1, state->tablero[v]});
+        keepTop(b->best, &b->bestMember, a->hang[v][0], v);
+        if (a->low[v] >= a->disc[a->parent[v]]) {
+            b->down = join(b->members, b->best[0]);
+            keepTop(a->hang[b->head], &a->hangBlock[b->head], b->down, id);
+        }
+    }
+
+    // En orden directo el bloque de la cabeza ya tiene su salida hacia arriba
+    for (int i = 1; i < count; i++) {
+        int v = a->order[i];
+        if (a->low[v] < a->disc[a->parent[v]]) continue;
+        int id = a->blockOf[v];
+        block_t *b = &a->blocks[id];
+        b->up = topExcept(a->hang[b->head], a->hangBlock[b->head], id);
+        if (b->head != root) {
+            b->up = better(b->up, enterBlock(a, state, a->blockOf[b->head], b->head));
+        }
+    }
+}
+
+// Resultado de entrar por una celda de la región que armó buildBlocks
+static void chamberAt(const chamber_analyzer_t *a, game_state_t *state, int cell, chamber_info_t *info) {
+    span_t best = a->hang[cell][0];
+    if (cell != a->order[0]) {
+        best = better(best, enterBlock(a, state, a->blockOf[cell], cell));
+    }
+    info->cells = 1 + best.cells;
+    info->value = state->tablero[cell] + best.value;
+}
+
+void chamberFrom(chamber_analyzer_t *a, game_state_t *state, unsigned short x, unsigned short y, chamber_info_t *info) {
+    memset(info, 0, sizeof(*info));
+    if (x >= state->width || y >= state->height) return;
+    int root = y * state->width + x;
+    if (state->tablero[root] <= 0) return;
+
+    unsigned int gen = nextGeneration(a);
+    a->width = state->width;
+    explore(a, state, root, gen, info);
+}
+
+void analyzeMoves(chamber_analyzer_t *a, game_state_t *state, unsigned short x, unsigned short y, chamber_info_t info[8]) {
+    int width = state->width;
+    unsigned char legal = state->legal_moves[y * width + x];
+    unsigned int gen = nextGeneration(a);
+    a->width = width;
+    memset(info, 0, 8 * sizeof(chamber_info_t));
+
+    // Una pasada por región: los vecinos que caen en una región ya recorrida
+    // salen del árbol de bloques de esa pasada
+    for (int d = 0; d < 8; d++) {
+        if (!(legal & (1 << d)) || info[d].reachable > 0) continue;
+        chamber_info_t region;
+        int count = explore(a, state, (y + dirY[d]) * width + x + dirX[d], gen, &region);
+        buildBlocks(a, state, count);
+        for (int e = d; e < 8; e++) {
+            if (!(legal & (1 << e)) || info[e].reachable > 0) continue;
+            int cell = (y + dirY[e]) * width + x + dirX[e];
+            if (a->visited[cell] != gen) continue;
+            info[e] = region;
+            chamberAt(a, state, cell, &info[e]);
+        }
+    }
+}
+
+int isArticulation(const chamber_analyzer_t *a, unsigned short x, unsigned short y) {
+    return a->articulation[y * a->width + x] == a->generation;
+}
+
+void releaseChamberAnalyzer(chamber_analyzer_t *a) {
+    free(a);
+}
@@ -0,0 +1,57 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file chomprank.c
+ * @brief Muestra la tabla de ratings que acumulan los másters con -r
+ *
+ * Copia el archivo bajo un lock compartido y lista los binarios ordenados
+ * por rating, con partidas, victorias y puntaje promedio. Se puede correr
+ * mientras otros másters siguen registrando partidas.
+ *
+ * Uso: chomprank archivo
+ *
+ * @author Grupo 21
+ * @date 2025
+ */
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ratings.h>
+
+static int compareRating(const void *a, const void *b) {
+    const rating_entry_t *ea = a, *eb = b;
+    return (eb->rating > ea->rating) - (eb->rating < ea->rating);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Uso: %s archivo\n", argv[0]);
+        return 1;
+    }
+
+    ratings_t ratings;
+    if (openRatings(&ratings, argv[1], 0) != 0) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    static rating_store_t copy;
+    lockRatings(&ratings, 1);
+    memcpy(&copy, ratings.store, sizeof(copy));
+    lockRatings(&ratings, 0);
+    closeRatings(&ratings);
+
+    qsort(copy.entries, copy.count, sizeof(rating_entry_t), compareRating);
+
+    printf("%llu partidas registradas\n", copy.games);
+    printf("%4s  %-16s %8s %8s %8s %10s\n", "#", "jugador", "rating", "partidas", "victorias", "prom.");
+    for (unsigned int i = 0; i < copy.count; i++) {
+        rating_entry_t *e = &copy.entries[i];
+        printf("%4u  %-16s %8.1f %8u %8u %10.1f\n", i + 1, e->name, e->rating, e->games, e->wins,
+               e->games ? (double)e->score / e->games : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file chompstat.c
+ * @brief Monitor de estadísticas del máster de ChompChamps
+ *
+ * Se conecta al segmento de estadísticas que publica el máster y muestra,
+ * al estilo de vmstat, las tasas de cada intervalo: movimientos por segundo,
+ * despertares, tiempo bloqueado en locks y en la vista, y duración media de
+ * las iteraciones del bucle principal.
+ *
+ * Uso: chompstat [intervalo [cantidad]]
+ *
+ * @author Grupo 21
+ * @date 2025
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <stats.h>
+#include <session.h>
+
+#define HEADER_EVERY 20
+
+/**
+ * @brief Imprime el encabezado de columnas
+ */
+void printHeader() {
+    printf("%8s %8s %8s %8s %8s %9s %9s %9s %6s %5s\n",
+           "moves/s", "valid/s", "inval/s", "polls/s", "wakes/s",
+           "lock ms/s", "view ms/s", "tick us", "active", "games");
+}
+
+/**
+ * @brief Imprime una línea con las tasas entre dos muestras
+ * 
+ * @param prev Muestra anterior
+ * @param cur Muestra actual
+ * @param seconds Segundos transcurridos entre muestras
+ */
+void printRates(const master_stats_t *prev, const master_stats_t *cur, double seconds) {
+    unsigned long long ticks = cur->ticks - prev->ticks;
+    double tick_us = ticks > 0 ? (cur->tick_ns - prev->tick_ns) / 1000.0 / ticks : 0.0;
+
+    printf("%8.0f %8.0f %8.0f %8.0f %8.0f %9.1f %9.1f %9.1f %6u %5u\n",
+           (cur->moves - prev->moves) / seconds,
+           (cur->valid_moves - prev->valid_moves) / seconds,
+           (cur->invalid_moves - prev->invalid_moves) / seconds,
+           (cur->polls - prev->polls) / seconds,
+           (cur->wakeups - prev->wakeups) / seconds,
+           (cur->lock_wait_ns - prev->lock_wait_ns) / 1e6 / seconds,
+           (cur->view_wait_ns - prev->view_wait_ns) / 1e6 / seconds,
+           tick_us,
+           cur->players_active,
+           cur->games_played);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+    int interval = argc > 1 ? atoi(argv[1]) : 1;
+    int count = argc > 2 ? atoi(argv[2]) : -1;
+    if (interval <= 0) {
+        fprintf(stderr, "Uso: %s [intervalo [cantidad]]\n", argv[0]);
+        return 1;
+    }
+
+    char shm_name[SHM_NAME_LENGTH];
+    int fd = shm_open(sessionShmName(STATS_SHM_NAME, shm_name), O_RDONLY, 0);
+    if (fd == -1) {
+        perror("shm_open game_stats (¿está corriendo el máster?)");
+        return 1;
+    }
+    master_stats_t *stats = mmap(NULL, sizeof(master_stats_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (stats == MAP_FAILED) {
+        perror("mmap game_stats");
+        return 1;
+    }
+
+    master_stats_t prev;
+    memcpy(&prev, stats, sizeof(prev));
+    struct timespec last;
+    clock_gettime(CLOCK_MONOTONIC, &last);
+
+    for (int line = 0; count < 0 || line < count; line++) {
+        sleep(interval);
+
+        master_stats_t cur;
+        memcpy(&cur, stats, sizeof(cur));
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        double seconds = (now.tv_sec - last.tv_sec) + (now.tv_nsec - last.tv_nsec) / 1e9;
+
+        if (line % HEADER_EVERY == 0) printHeader();
+        printRates(&prev, &cur, seconds);
+
+        if (!cur.running) break;
+        prev = cur;
+        last = now;
+    }
+
+    munmap(stats, sizeof(master_stats_t));
+    return 0;
+}
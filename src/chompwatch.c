@@ -0,0 +1,300 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file chompwatch.c
+ * @brief Espectador de partidas de ChompChamps por socket Unix
+ *
+ * Se conecta al socket que abre el máster con --spectate, reconstruye el
+ * estado a partir de la foto inicial y los cambios de cada jugador, y lo
+ * dibuja como la vista, sin frenar al máster. También puede grabar el flujo
+ * crudo en un archivo y volver a leerlo después.
+ *
+ * Uso: chompwatch [-q] [-i ms] [-r archivo] [-f] socket
+ *
+ * @author Grupo 21
+ * @date 2025
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <spectate.h>
+#include <render.h>
+
+#define DEFAULT_INTERVAL_MS 100
+#define CONNECT_RETRY_MS 50
+#define CONNECT_TIMEOUT_MS 5000
+
+/**
+ * @brief Opciones del espectador
+ */
+typedef struct {
+    int quiet;              ///< 1 para no dibujar y solo resumir cada partida
+    int interval_ms;        ///< Tiempo mínimo entre dibujos
+    const char *record;     ///< Archivo donde grabar el flujo crudo (NULL = no grabar)
+    int from_file;          ///< 1 si path es una grabación y no un socket
+    const char *path;
+} watch_config_t;
+
+/**
+ * @brief Contadores de la partida en curso para el resumen de -q
+ */
+typedef struct {
+    unsigned long long updates;
+    unsigned long long captures;
+    unsigned int resyncs;   ///< Fotos recibidas a mitad de partida
+} watch_summary_t;
+
+static long long nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+}
+
+static void sleepMs(int ms) {
+    struct timespec ts = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+static void showHelp(const char *program) {
+    fprintf(stderr, "Uso: %s [-q] [-i ms] [-r archivo] [-f] socket\n", program);
+    fprintf(stderr, "  -q          No dibujar: resumir cada partida al terminar\n");
+    fprintf(stderr, "  -i ms       Tiempo mínimo entre dibujos (default: %d)\n", DEFAULT_INTERVAL_MS);
+    fprintf(stderr, "  -r archivo  Grabar el flujo crudo en un archivo\n");
+    fprintf(stderr, "  -f          Leer una grabación en lugar de conectarse a un socket\n");
+}
+
+/**
+ * @brief Se conecta al socket, reintentando mientras el máster no lo haya creado
+ *
+ * @param path Ruta del socket
+ * @return Descriptor conectado, -1 en error
+ */
+int connectSpectator(const char *path) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    for (int waited = 0;; waited += CONNECT_RETRY_MS) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd == -1) return -1;
+        if (connect(fd, (struct sockaddr *)&address, sizeof(address)) == 0) return fd;
+        int error = errno;
+        close(fd);
+        if ((error != ENOENT && error != ECONNREFUSED) || waited >= CONNECT_TIMEOUT_MS) {
+            errno = error;
+            return -1;
+        }
+        sleepMs(CONNECT_RETRY_MS);
+    }
+}
+
+/**
+ * @brief Lee exactamente size bytes
+ *
+ * @return 1 si se leyó todo, 0 si el flujo terminó, -1 en error
+ */
+int readFull(int fd, void *data, size_t size) {
+    size_t got = 0;
+    while (got < size) {
+        ssize_t n = read(fd, (char *)data + got, size - got);
+        if (n == 0) return 0;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        got += n;
+    }
+    return 1;
+}
+
+static void applyRanking(game_state_t *state, const unsigned char ranking[MAX_JUGADORES]) {
+    for (int i = 0; i < MAX_JUGADORES; i++) {
+        state->ranking[i] = ranking[i];
+    }
+}
+
+/**
+ * @brief Aplica una foto completa al estado local
+ *
+ * @param state Estado local
+ * @param payload Contenido del mensaje
+ * @param length Bytes de contenido
+ * @return Partida de la foto, -1 si el mensaje es inválido
+ */
+int applySnapshot(game_state_t *state, const char *payload, size_t length) {
+    const spectate_snapshot_t *snapshot = (const spectate_snapshot_t *)payload;
+    if (length < sizeof(*snapshot)) return -1;
+    size_t cells = (size_t)snapshot->width * snapshot->height;
+    if (cells > MAX_WIDTH * MAX_HEIGHT || snapshot->num_jugadores > MAX_JUGADORES
+        || length != sizeof(*snapshot) + cells * sizeof(int)) {
+        return -1;
+    }
+    state->width = snapshot->width;
+    state->height = snapshot->height;
+    state->num_jugadores = snapshot->num_jugadores;
+    state->terminado = snapshot->terminado;
+    memcpy(state->jugadores, snapshot->jugadores, sizeof(state->jugadores));
+    applyRanking(state, snapshot->ranking);
+    memcpy(state->tablero, snapshot + 1, cells * sizeof(int));
+    return (int)snapshot->game;
+}
+
+/**
+ * @brief Aplica el cambio de un jugador al estado local
+ *
+ * @param state Estado local
+ * @param update Cambio recibido
+ * @return 0 en éxito, -1 si el cambio no corresponde al estado
+ */
+int applyUpdate(game_state_t *state, const spectate_player_t *update) {
+    if (update->player >= state->num_jugadores) return -1;
+    state->jugadores[update->player] = update->row;
+    if (update->captured) {
+        if (update->row.x >= state->width || update->row.y >= state->height) return -1;
+        state->tablero[update->row.y * state->width + update->row.x] = -update->player;
+    }
+    applyRanking(state, update->ranking);
+    return 0;
+}
+
+static void drawFrame(game_state_t *state, int frame) {
+    printStatus(state, "=== Leaderboard ===");
+    putchar('\n');
+    printAnimatedBar(state->width, -1 - frame);
+    drawBoard(state);
+    printAnimatedBar(state->width, frame);
+    fflush(stdout);
+}
+
+static void printSummary(const game_state_t *state, int game, const watch_summary_t *summary) {
+    printf("Partida %d: %ux%u, %llu cambios, %llu capturas, %u resincronizaciones\n",
+           game + 1, state->width, state->height, summary->updates, summary->captures, summary->resyncs);
+    for (unsigned int i = 0; i < state->num_jugadores; i++) {
+        const jugador_t *player = &state->jugadores[state->ranking[i]];
+        printf("  %u. %-16s %6u (%u válidos, %u inválidos)\n",
+               i + 1, player->nombre, player->puntaje, player->validRequests, player->invalidRequests);
+    }
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+    watch_config_t config = {0, DEFAULT_INTERVAL_MS, NULL, 0, NULL};
+    int opt;
+    while ((opt = getopt(argc, argv, "qi:r:f")) != -1) {
+        switch (opt) {
+            case 'q': config.quiet = 1; break;
+            case 'i': config.interval_ms = atoi(optarg); break;
+            case 'r': config.record = optarg; break;
+            case 'f': config.from_file = 1; break;
+            default: showHelp(argv[0]); return 1;
+        }
+    }
+    if (optind != argc - 1) {
+        showHelp(argv[0]);
+        return 1;
+    }
+    config.path = argv[optind];
+
+    int fd = config.from_file ? open(config.path, O_RDONLY) : connectSpectator(config.path);
+    if (fd == -1) {
+        perror(config.path);
+        return 1;
+    }
+    int record_fd = -1;
+    if (config.record != NULL && (record_fd = open(config.record, O_WRONLY | O_CREAT | O_TRUNC, 0644)) == -1) {
+        perror(config.record);
+        close(fd);
+        return 1;
+    }
+
+    game_state_t *state = calloc(1, sizeof(game_state_t));
+    char *payload = malloc(sizeof(spectate_snapshot_t) + sizeof(int) * MAX_WIDTH * MAX_HEIGHT);
+    if (state == NULL || payload == NULL) {
+        perror("malloc");
+        return 1;
+    }
+
+    int game = -1;
+    int frame = 0;
+    long long last_draw = 0;
+    watch_summary_t summary = {0, 0, 0};
+    spectate_header_t header;
+    int status;
+
+    while ((status = readFull(fd, &header, sizeof(header))) == 1) {
+        if (header.length > sizeof(spectate_snapshot_t) + sizeof(int) * MAX_WIDTH * MAX_HEIGHT) {
+            fprintf(stderr, "chompwatch: mensaje de %u bytes fuera de rango\n", header.length);
+            status = -1;
+            break;
+        }
+        if ((status = readFull(fd, payload, header.length)) != 1) break;
+        if (record_fd != -1 && (write(record_fd, &header, sizeof(header)) == -1
+                                || write(record_fd, payload, header.length) == -1)) {
+            perror(config.record);
+            close(record_fd);
+            record_fd = -1;
+        }
+
+        int force_draw = 0;
+        if (header.type == SPECTATE_SNAPSHOT) {
+            int snapshot_game = applySnapshot(state, payload, header.length);
+            if (snapshot_game < 0) {
+                status = -1;
+                break;
+            }
+            if (snapshot_game == game) {
+                summary.resyncs++;
+            } else {
+                game = snapshot_game;
+                summary = (watch_summary_t){0, 0, 0};
+            }
+            force_draw = 1;
+        } else if (header.type == SPECTATE_PLAYER) {
+            if (game < 0 || header.length != sizeof(spectate_player_t)
+                || applyUpdate(state, (const spectate_player_t *)payload) != 0) {
+                status = -1;
+                break;
+            }
+            summary.updates++;
+            summary.captures += ((const spectate_player_t *)payload)->captured;
+        } else if (header.type == SPECTATE_END) {
+            state->terminado = 1;
+            if (config.quiet) {
+                printSummary(state, game, &summary);
+            } else {
+                gameEnded(state, NULL);
+            }
+            continue;
+        }
+
+        if (config.quiet) continue;
+        long long now = nowMs();
+        if (force_draw || now - last_draw >= config.interval_ms) {
+            drawFrame(state, frame++);
+            last_draw = now;
+        }
+    }
+    if (status < 0) {
+        fprintf(stderr, "chompwatch: flujo inválido o error de lectura\n");
+    }
+
+    if (record_fd != -1) close(record_fd);
+    close(fd);
+    free(payload);
+    free(state);
+    return status < 0 ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _DEFAULT_SOURCE
+#include <endgame.h>
+#include <game.h>
+#include <string.h>
+
+#define CELLS (MAX_WIDTH * MAX_HEIGHT)
+#define EXACT_MAX_CELLS 40        // Regiones más grandes van directo a la heurística
+#define EXACT_NODE_LIMIT 200000   // Nodos del DFS por decisión antes de rendirse
+
+// La región se compacta a índices 0..n-1 con listas de adyacencia
+struct endgame_solver {
+    unsigned int generation;
+    unsigned int mark[CELLS];   // mark[celda] == generation si la celda está en la región
+    int compact[CELLS];         // Índice compacto de cada celda de la región
+    int n;
+    int value[CELLS];
+    int adj[CELLS][8];
+    unsigned char deg[CELLS];
+    unsigned char visited[CELLS];
+    unsigned char seen[CELLS];  // Marcas de la cota por inundación
+    int stack[CELLS];
+    long nodes;
+    int best;
+};
+
+endgame_solver_t *createEndgameSolver(void) {
+    return calloc(1, sizeof(endgame_solver_t));
+}
+
+// Inunda desde los vecinos libres del jugador y arma el grafo compacto
+static void buildRegion(endgame_solver_t *s, game_state_t *state, int px, int py) {
+    if (++s->generation == 0) {
+        memset(s->mark, 0, sizeof(s->mark));
+        s->generation = 1;
+    }
+    int width = state->width;
+    int top = 0;
+    s->n = 0;
+
+    unsigned char legal = state->legal_moves[py * width + px];
+    for (int d = 0; d < 8; d++) {
+        if (!(legal & (1 << d))) continue;
+        int cell = (py + dirY[d]) * width + px + dirX[d];
+        if (s->mark[cell] == s->generation) continue;
+        s->mark[cell] = s->generation;
+        s->stack[top++] = cell;
+    }
+
+    while (top > 0) {
+        int cell = s->stack[--top];
+        s->compact[cell] = s->n;
+        s->value[s->n] = state->tablero[cell];
+        s->n++;
+        legal = state->legal_moves[cell];
+        for (int d = 0; d < 8; d++) {
+            if (!(legal & (1 << d))) continue;
+            int next = cell + dirY[d] * width + dirX[d];
+            if (s->mark[next] == s->generation) continue;
+            s->mark[next] = s->generation;
+            s->stack[top++] = next;
+        }
+    }
+}
+
+// Ningún rival activo puede tener una celda de la región como vecina
+static int regionIsolated(endgame_solver_t *s, game_state_t *state, unsigned int playerId) {
+    for (unsigned int i = 0; i < state->num_jugadores; i++) {
+        jugador_t *other = &state->jugadores[i];
+        if (i == playerId || other->stuck) continue;
+        for (int d = 0; d < 8; d++) {
+            int x = other->x + dirX[d];
+            int y = other->y + dirY[d];
+            if (x < 0 || x >= state->width || y < 0 || y >= state->height) continue;
+            if (s->mark[y * state->width + x] == s->generation) return 0;
+        }
+    }
+    return 1;
+}
+
+static void buildAdjacency(endgame_solver_t *s, game_state_t *state) {
+    int width = state->width;
+    for (int y = 0; y < state->height; y++) {
+        for (int x = 0; x < width; x++) {
+            int cell = y * width + x;
+            if (s->mark[cell] != s->generation) continue;
+            int u = s->compact[cell];
+            s->deg[u] = 0;
+            unsigned char legal = state->legal_moves[cell];
+            for (int d = 0; d < 8; d++) {
+                if (legal & (1 << d)) {
+                    s->adj[u][s->deg[u]++] = s->compact[cell + dirY[d] * width + dirX[d]];
+                }
+            }
+        }
+    }
+}
+
+static int onwardDegree(const endgame_solver_t *s, int u) {
+    int count = 0;
+    for (int i = 0; i < s->deg[u]; i++) {
+        if (!s->visited[s->adj[u][i]]) count++;
+    }
+    return count;
+}
+
+// Recorrido goloso pegado a las paredes: siempre al vecino con menos salidas
+static int rollout(endgame_solver_t *s, int first) {
+    memset(s->visited, 0, s->n);
+    int u = first;
+    int total = s->value[u];
+    s->visited[u] = 1;
+    for (;;) {
+        int next = -1, nextDeg = 9;
+        for (int i = 0; i < s->deg[u]; i++) {
+            int v = s->adj[u][i];
+            if (s->visited[v]) continue;
+            int deg = onwardDegree(s, v);
+            if (deg < nextDeg || (deg == nextDeg && s->value[v] > s->value[next])) {
+                next = v;
+                nextDeg = deg;
+            }
+        }
+        if (next < 0) return total;
+        s->visited[next] = 1;
+        total += s->value[next];
+        u = next;
+    }
+}
+
+// Recompensa de todo lo que sigue alcanzable desde u sin pisar celdas visitadas
+static int reachableValue(endgame_solver_t *s, int u) {
+    memset(s->seen, 0, s->n);
+    int top = 0, sum = 0;
+    s->stack[top++] = u;
+    s->seen[u] = 1;
+    while (top > 0) {
+        int w = s->stack[--top];
+        for (int i = 0; i < s->deg[w]; i++) {
+            int v = s->adj[w][i];
+            if (s->visited[v] || s->seen[v]) continue;
+            s->seen[v] = 1;
+            sum += s->value[v];
+            s->stack[top++] = v;
+        }
+    }
+    return sum;
+}
+
+// DFS con cota; devuelve 0 si se agotó el presupuesto de nodos
+static int search(endgame_solver_t *s, int u, int collected) {
+    if (++s->nodes > EXACT_NODE_LIMIT) return 0;
+    if (collected > s->best) s->best = collected;
+    if (collected + reachableValue(s, u) <= s->best) return 1;
+
+    // Primero los vecinos con menos salidas, que suelen llevar a buenos recorridos
+    int order[8], keys[8], count = 0;
+    for (int i = 0; i < s->deg[u]; i++) {
+        int v = s->adj[u][i];
+        if (s->visited[v]) continue;
+        int key = onwardDegree(s, v);
+        int j = count++;
+        while (j > 0 && keys[j - 1] > key) {
+            order[j] = order[j - 1];
+            keys[j] = keys[j - 1];
+            j--;
+        }
+        order[j] = v;
+        keys[j] = key;
+    }
+
+    for (int i = 0; i < count; i++) {
+        int v = order[i];
+        s->visited[v] = 1;
+        int finished = search(s, v, collected + s->value[v]);
+        s->visited[v] = 0;
+        if (!finished) return 0;
+    }
+    return 1;
+}
+
+int solveEndgame(endgame_solver_t *s, game_state_t *state, unsigned int playerId, endgame_result_t *result) {
+    jugador_t *player = &state->jugadores[playerId];
+    unsigned char legal = state->legal_moves[player->y * state->width + player->x];
+    if (!legal) return 0;
+
+    buildRegion(s, state, player->x, player->y);
+    if (!regionIsolated(s, state, playerId)) return 0;
+    buildAdjacency(s, state);
+
+    result->cells = s->n;
+    result->value = -1;
+    result->exact = s->n <= EXACT_MAX_CELLS;
+    s->nodes = 0;
+
+    for (int d = 0; d < 8; d++) {
+        if (!(legal & (1 << d))) continue;
+        int first = s->compact[(player->y + dirY[d]) * state->width + player->x + dirX[d]];
+
+        // La heurística da una cota inferior que el DFS intenta superar
+        s->best = rollout(s, first);
+        if (s->n <= EXACT_MAX_CELLS) {
+            memset(s->visited, 0, s->n);
+            s->visited[first] = 1;
+            if (!search(s, first, s->value[first])) result->exact = 0;
+        }
+
+        if (s->best > result->value) {
+            result->value = s->best;
+            result->move = d;
+        }
+    }
+    return 1;
+}
+
+void releaseEndgameSolver(endgame_solver_t *s) {
+    free(s);
+}
@@ -0,0 +1,183 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _DEFAULT_SOURCE
+#include <game.h>
+#include <math.h>
+#include <string.h>
+
+// Índice del bloque que contiene una celda
+static inline int tileIndex(int x, int y) {
+    return (y / TILE_SIZE) * TILE_COLS + x / TILE_SIZE;
+}
+
+void initNeighborTables(game_state_t *state) {
+    memset(state->tile_free_value, 0, sizeof(state->tile_free_value));
+    memset(state->tile_owned, 0, sizeof(state->tile_owned));
+
+    for (int y = 0; y < state->height; y++) {
+        for (int x = 0; x < state->width; x++) {
+            int val = state->tablero[y * state->width + x];
+            if (val > 0) {
+                state->tile_free_value[tileIndex(x, y)] += val;
+            } else if (-val < MAX_JUGADORES) {
+                state->tile_owned[tileIndex(x, y)][-val]++;
+            }
+
+            unsigned char mask = 0;
+            for (int d = 0; d < 8; d++) {
+                int nx = x + dirX[d];
+                int ny = y + dirY[d];
+                if (nx < 0 || nx >= state->width || ny < 0 || ny >= state->height) continue;
+                if (state->tablero[ny * state->width + nx] > 0) {
+                    mask |= 1 << d;
+                }
+            }
+            state->legal_moves[y * state->width + x] = mask;
+            state->free_neighbors[y * state->width + x] = __builtin_popcount(mask);
+        }
+    }
+}
+
+void updateNeighborTables(game_state_t *state, unsigned short x, unsigned short y) {
+    for (int d = 0; d < 8; d++) {
+        int nx = x + dirX[d];
+        int ny = y + dirY[d];
+        if (nx < 0 || nx >= state->width || ny < 0 || ny >= state->height) continue;
+
+        // Desde el vecino, la celda ocupada está en la dirección opuesta
+        unsigned char bit = 1 << ((d + 4) % 8);
+        int idx = ny * state->width + nx;
+        if (state->legal_moves[idx] & bit) {
+            state->legal_moves[idx] &= ~bit;
+            state->free_neighbors[idx]--;
+        }
+    }
+}
+
+int movePlayer(game_state_t *state, int playerId, unsigned short targetX, unsigned short targetY) {
+    if (targetX >= state->width || targetY >= state->height) {
+        return 0;
+    }
+    int score = state->tablero[targetY * state->width + targetX];
+    if (score <= 0) {
+        return 0;
+    }
+    state->jugadores[playerId].x = targetX;
+    state->jugadores[playerId].y = targetY;
+    state->tablero[targetY * state->width + targetX] = -playerId;
+    updateNeighborTables(state, targetX, targetY);
+    int tile = tileIndex(targetX, targetY);
+    state->tile_free_value[tile] -= score;
+    state->tile_owned[tile][playerId]++;
+    return score;
+}
+
+int isEscapable(game_state_t *state, unsigned short centerX, unsigned short centerY) {
+    return state->free_neighbors[centerY * state->width + centerX] > 0;
+}
+
+int isStuck(game_state_t *state, int playerId) {
+    jugador_t player = state->jugadores[playerId];
+    return player.stuck || !isEscapable(state, player.x, player.y);
+}
+
+int regionsDecided(game_state_t *state, const int active_players[], unsigned int bounds[]) {
+    static int label[MAX_WIDTH * MAX_HEIGHT];
+    static int queue[MAX_WIDTH * MAX_HEIGHT];
+    static unsigned int regionValue[MAX_WIDTH * MAX_HEIGHT];
+    static int regionOwner[MAX_WIDTH * MAX_HEIGHT];
+    int cells = state->width * state->height;
+    int regions = 0;
+
+    for (int i = 0; i < cells; i++) {
+        label[i] = -1;
+    }
+
+    for (int start = 0; start < cells; start++) {
+        if (label[start] != -1 || state->tablero[start] <= 0) continue;
+
+        int qHead = 0, qTail = 0;
+        queue[qTail++] = start;
+        label[start] = regions;
+        regionValue[regions] = 0;
+        regionOwner[regions] = -1;
+
+        while (qHead < qTail) {
+            int cell = queue[qHead++];
+            int x = cell % state->width;
+            int y = cell / state->width;
+            regionValue[regions] += state->tablero[cell];
+
+            unsigned char mask = state->legal_moves[cell];
+            for (int d = 0; d < 8; d++) {
+                if (!(mask & (1 << d))) continue;
+                int next = (y + dirY[d]) * state->width + (x + dirX[d]);
+                if (label[next] != -1) continue;
+                label[next] = regions;
+                queue[qTail++] = next;
+            }
+        }
+        regions++;
+    }
+
+    for (size_t p = 0; p < state->num_jugadores; p++) {
+        if (bounds != NULL) bounds[p] = 0;
+        if (!active_players[p]) continue;
+
+        jugador_t *player = &state->jugadores[p];
+        int cell = player->y * state->width + player->x;
+        unsigned char mask = state->legal_moves[cell];
+        for (int d = 0; d < 8; d++) {
+            if (!(mask & (1 << d))) continue;
+            int region = label[(player->y + dirY[d]) * state->width + (player->x + dirX[d])];
+            if (regionOwner[region] != -1 && regionOwner[region] != (int)p) {
+                return 0;
+            }
+            regionOwner[region] = p;
+            if (bounds != NULL && regionValue[region] > bounds[p]) {
+                bounds[p] = regionValue[region];
+            }
+        }
+    }
+    return 1;
+}
+
+uint64_t boardRandom(uint64_t seed, uint64_t counter) {
+    uint64_t z = (seed << 32 ^ seed) + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void fillBoardBlock(int *tablero, uint64_t seed, size_t from, size_t to) {
+    for (size_t i = from; i < to; i++) {
+        // Reducción de rango por multiplicación: uniforme y sin división
+        uint64_t high = boardRandom(seed, i) >> 32;
+        tablero[i] = 1 + (int)((high * 9) >> 32);
+    }
+}
+
+void generateBoard(game_state_t *state, unsigned int seed) {
+    // Con el tablero acotado a MAX_WIDTH * MAX_HEIGHT un único bloque es lo
+    // más rápido; los bloques son independientes si hiciera falta repartirlos
+    fillBoardBlock(state->tablero, seed, 0, (size_t)state->width * state->height);
+}
+
+void setStartingPositions(game_state_t *state, unsigned int seed) {
+    // El ángulo inicial usa el primer valor del generador posterior al tablero
+    uint64_t r = boardRandom(seed, (uint64_t)state->width * state->height);
+    double angleStep = 2*M_PI/state->num_jugadores;
+    double angle = (r >> 11) * (1.0 / 9007199254740992.0) * 2*M_PI;
+
+    unsigned short centerX = state->width/2;
+    unsigned short centerY = state->height/2;
+    double radius = (state->width < state->height ? state->width : state->height)*0.375;
+
+    for (size_t i = 0; i < state->num_jugadores; i++)
+    {
+        unsigned short x = centerX + cos(angle)*radius;
+        unsigned short y = centerY + sin(angle)*radius;
+        movePlayer(state, i, x, y);
+        angle += angleStep;
+    }
+}
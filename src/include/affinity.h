@@ -0,0 +1,40 @@
+#ifndef AFFINITY_H
+#define AFFINITY_H
+
+#define MAX_CPU_LIST 256
+
+/**
+ * @brief Lista de CPUs en el orden en que se escribieron
+ */
+typedef struct {
+    int count;              ///< CPUs en la lista (0 = sin fijar)
+    int cpus[MAX_CPU_LIST];
+} cpu_list_t;
+
+/**
+ * @brief Parsea una lista de CPUs como "0,2,4-7"
+ *
+ * @param text Lista de CPUs y rangos separados por comas
+ * @param list Donde se guarda la lista
+ * @return 0 en éxito, -1 si el texto no es una lista válida
+ */
+int parseCpuList(const char *text, cpu_list_t *list);
+
+/**
+ * @brief Restringe el proceso actual al conjunto de CPUs de la lista
+ *
+ * @param list Lista de CPUs; si está vacía no se hace nada
+ * @return 0 en éxito, -1 en error
+ */
+int pinToCpuList(const cpu_list_t *list);
+
+/**
+ * @brief Fija el proceso actual a una CPU de la lista, repartiendo por índice
+ *
+ * @param list Lista de CPUs; si está vacía no se hace nada
+ * @param index Índice del proceso (se usa la CPU index % count)
+ * @return 0 en éxito, -1 en error
+ */
+int pinToCpuSlot(const cpu_list_t *list, int index);
+
+#endif
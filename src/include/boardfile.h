@@ -0,0 +1,94 @@
+#ifndef BOARDFILE_H
+#define BOARDFILE_H
+
+#include <stddef.h>
+#include <structs.h>
+
+#define BOARD_FILE_MAGIC 0x44524243u   // "CBRD"
+#define BOARD_FILE_VERSION 1
+
+/**
+ * @brief Encabezado de un archivo de tableros
+ *
+ * Todos los tableros del archivo tienen el mismo tamaño, así que cada
+ * registro ocupa record_size bytes y el tablero i está en
+ * sizeof(board_file_header_t) + i * record_size. Se usa el orden de bytes
+ * del host, como el resto de los archivos binarios del proyecto.
+ */
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned short width;
+    unsigned short height;
+    unsigned int positions;     ///< Posiciones de partida guardadas por tablero
+    unsigned int count;         ///< Tableros en el archivo
+    unsigned int record_size;   ///< Bytes de cada registro
+} board_file_header_t;
+
+/**
+ * @brief Comienzo de cada registro; le siguen width * height bytes con los valores (1 a 9)
+ *
+ * Las celdas de partida se guardan con valor 1, ya que el jugador las ocupa
+ * antes de poder sumarlas.
+ */
+typedef struct {
+    unsigned short x[MAX_JUGADORES];
+    unsigned short y[MAX_JUGADORES];
+} board_positions_t;
+
+/**
+ * @brief Archivo de tableros abierto y mapeado en memoria
+ */
+typedef struct {
+    int fd;
+    const board_file_header_t *header;  ///< NULL si no hay archivo abierto
+    size_t size;
+} board_file_t;
+
+/**
+ * @brief Abre un archivo de tableros y valida todos sus registros
+ *
+ * Verifica que cada tablero tenga valores entre 1 y 9 y al menos players
+ * posiciones de partida distintas dentro del tablero, para que cargarlos
+ * después no pueda fallar.
+ *
+ * @param file Donde se guarda el archivo abierto
+ * @param path Ruta del archivo
+ * @param players Jugadores de la partida
+ * @return 0 en éxito, -1 en error (con errno indicando la causa)
+ */
+int openBoardFile(board_file_t *file, const char *path, unsigned int players);
+
+/**
+ * @brief Carga un tablero del archivo en el estado y ubica a los jugadores
+ *
+ * Usa state->num_jugadores y deja listas las tablas derivadas, como
+ * generateBoard, initNeighborTables y setStartingPositions juntas.
+ *
+ * @param file Archivo abierto con openBoardFile
+ * @param index Tablero a cargar (el máster usa la semilla de la partida); se recorre el archivo en ronda
+ * @param state Estado a llenar
+ */
+void loadBoard(const board_file_t *file, unsigned int index, game_state_t *state);
+
+/**
+ * @brief Desmapea y cierra un archivo de tableros
+ *
+ * @param file Archivo a cerrar
+ */
+void closeBoardFile(board_file_t *file);
+
+/**
+ * @brief Agrega el tablero inicial de una partida al final de un archivo
+ *
+ * Si el archivo está vacío escribe el encabezado; si no, el tablero debe
+ * tener el mismo tamaño y cantidad de jugadores que los que ya tiene. Toma
+ * un lock exclusivo, así que varios másters pueden armar el mismo archivo.
+ *
+ * @param fd Descriptor abierto para lectura y escritura
+ * @param state Estado recién preparado, antes del primer movimiento
+ * @return 0 en éxito, -1 en error (con errno indicando la causa)
+ */
+int appendBoard(int fd, const game_state_t *state);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef CHAMBERS_H
+#define CHAMBERS_H
+
+#include <structs.h>
+
+typedef struct chamber_analyzer chamber_analyzer_t;
+
+/**
+ * @brief Resultado del análisis de cámaras desde una celda
+ *
+ * Una cámara es un bloque biconexo de celdas libres: se puede recorrer sin
+ * quedar encerrado. Al cruzar un punto de articulación se entra a un bolsillo
+ * del que no se puede volver, así que a lo sumo se aprovecha uno de ellos.
+ */
+typedef struct {
+    int cells;          ///< Celdas de la mejor cámara recorrible (cámara propia + mejor bolsillo)
+    int value;          ///< Suma de recompensas de esas celdas
+    int reachable;      ///< Celdas libres alcanzables en total
+    int articulations;  ///< Puntos de articulación en la región alcanzable
+} chamber_info_t;
+
+/**
+ * @brief Reserva el espacio de trabajo del análisis de cámaras
+ *
+ * @return Analizador listo para usar, o NULL si no hay memoria
+ */
+chamber_analyzer_t *createChamberAnalyzer(void);
+
+/**
+ * @brief Analiza las cámaras alcanzables entrando a una celda libre
+ *
+ * Recorre en profundidad (Tarjan, tiempo lineal) las celdas libres con
+ * 8-vecindad a partir de la celda, calculando los puntos de articulación y
+ * el espacio que realmente se puede recorrer desde ella.
+ *
+ * @param analyzer Espacio de trabajo
+ * @param state Estado actual del juego
+ * @param x Coordenada X de la celda
+ * @param y Coordenada Y de la celda
+ * @param info Donde se guarda el resultado (todo en cero si la celda no está libre)
+ */
+void chamberFrom(chamber_analyzer_t *analyzer, game_state_t *state, unsigned short x, unsigned short y, chamber_info_t *info);
+
+/**
+ * @brief Analiza la cámara de cada movimiento posible desde una posición
+ *
+ * @param analyzer Espacio de trabajo
+ * @param state Estado actual del juego
+ * @param x Coordenada X de la posición actual
+ * @param y Coordenada Y de la posición actual
+ * @param info Resultado por dirección (0 = arriba, en sentido horario), en cero si la dirección no es legal
+ */
+void analyzeMoves(chamber_analyzer_t *analyzer, game_state_t *state, unsigned short x, unsigned short y, chamber_info_t info[8]);
+
+/**
+ * @brief Indica si una celda fue punto de articulación en el último análisis
+ *
+ * @param analyzer Espacio de trabajo
+ * @param x Coordenada X de la celda
+ * @param y Coordenada Y de la celda
+ * @return 1 si separar la celda desconecta la región analizada, 0 si no
+ */
+int isArticulation(const chamber_analyzer_t *analyzer, unsigned short x, unsigned short y);
+
+/**
+ * @brief Libera el espacio de trabajo del análisis de cámaras
+ *
+ * @param analyzer Analizador a liberar
+ */
+void releaseChamberAnalyzer(chamber_analyzer_t *analyzer);
+
+#endif
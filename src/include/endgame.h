@@ -0,0 +1,49 @@
+#ifndef ENDGAME_H
+#define ENDGAME_H
+
+#include <structs.h>
+
+typedef struct endgame_solver endgame_solver_t;
+
+/**
+ * @brief Resultado del solver de final de partida
+ */
+typedef struct {
+    unsigned char move;  ///< Primer movimiento del mejor recorrido encontrado
+    int value;           ///< Recompensa total que junta ese recorrido
+    int cells;           ///< Celdas libres de la región aislada
+    int exact;           ///< 1 si el recorrido es óptimo, 0 si viene de la heurística o se agotó el presupuesto
+} endgame_result_t;
+
+/**
+ * @brief Reserva el espacio de trabajo del solver de final de partida
+ *
+ * @return Solver listo para usar, o NULL si no hay memoria
+ */
+endgame_solver_t *createEndgameSolver(void);
+
+/**
+ * @brief Resuelve la región de un jugador si ningún rival activo puede entrar a ella
+ *
+ * Con la región aislada, elegir movimiento es buscar el camino de mayor
+ * recompensa sin otros agentes. Las regiones chicas se resuelven con DFS
+ * acotado por la recompensa alcanzable, con un límite de nodos para respetar
+ * el plazo del movimiento; las grandes usan recorridos pegados a las paredes
+ * (regla de Warnsdorff) desde cada primer paso.
+ *
+ * @param solver Espacio de trabajo
+ * @param state Estado actual del juego
+ * @param playerId ID del jugador que decide
+ * @param result Donde se guarda el movimiento elegido
+ * @return 1 si el jugador está aislado y hay movimiento, 0 si hay que usar la estrategia normal
+ */
+int solveEndgame(endgame_solver_t *solver, game_state_t *state, unsigned int playerId, endgame_result_t *result);
+
+/**
+ * @brief Libera el espacio de trabajo del solver de final de partida
+ *
+ * @param solver Solver a liberar
+ */
+void releaseEndgameSolver(endgame_solver_t *solver);
+
+#endif
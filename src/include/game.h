@@ -0,0 +1,121 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdint.h>
+#include <structs.h>
+
+/**
+ * @brief Desplazamiento de cada dirección de movimiento (0 = arriba, en sentido horario)
+ *
+ * Es el código de movimiento que los jugadores le envían al máster, así que
+ * todos los módulos deben usar esta misma tabla.
+ */
+static const int dirX[8] = { 0, 1, 1, 1, 0, -1, -1, -1};
+static const int dirY[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+
+/**
+ * @brief Calcula desde cero las tablas de vecinos libres, movimientos legales y bloques
+ * 
+ * @param state Estado actual del juego
+ */
+void initNeighborTables(game_state_t *state);
+
+/**
+ * @brief Actualiza las tablas de los 8 vecinos de una celda recién ocupada
+ * 
+ * @param state Estado actual del juego
+ * @param x Coordenada X de la celda ocupada
+ * @param y Coordenada Y de la celda ocupada
+ */
+void updateNeighborTables(game_state_t *state, unsigned short x, unsigned short y);
+
+/**
+ * @brief Mueve un jugador a una posición y la ocupa en el tablero
+ * 
+ * @param state Estado actual del juego
+ * @param playerId ID del jugador a mover
+ * @param targetX Coordenada X de destino
+ * @param targetY Coordenada Y de destino
+ * @return 0 si el movimiento es inválido, el puntaje de la posición si es válido
+ */
+int movePlayer(game_state_t *state, int playerId, unsigned short targetX, unsigned short targetY);
+
+/**
+ * @brief Verifica si es posible escapar de una posición
+ * 
+ * @param state Estado actual del juego
+ * @param centerX Coordenada X central
+ * @param centerY Coordenada Y central
+ * @return 1 si es escapable, 0 si no
+ */
+int isEscapable(game_state_t *state, unsigned short centerX, unsigned short centerY);
+
+/**
+ * @brief Verifica si un jugador está atascado
+ * 
+ * @param state Estado actual del juego
+ * @param playerId ID del jugador a verificar
+ * @return 1 si está atascado, 0 si no
+ */
+int isStuck(game_state_t *state, int playerId);
+
+/**
+ * @brief Determina si el resultado de las regiones libres ya está decidido
+ * 
+ * Etiqueta las componentes conexas de celdas libres (8-vecindad) y revisa a
+ * cuáles puede entrar cada jugador activo. Si ninguna componente es alcanzable
+ * por dos o más jugadores activos, cada uno juega solo en lo que le queda.
+ * 
+ * @param state Estado actual del juego
+ * @param active_players Array de jugadores activos
+ * @param bounds Si no es NULL, recibe para cada jugador el valor de la mayor región a la que puede entrar
+ * @return 1 si ninguna región es disputada, 0 si no
+ */
+int regionsDecided(game_state_t *state, const int active_players[], unsigned int bounds[]);
+
+/**
+ * @brief Generador aleatorio basado en contador (SplitMix64)
+ * 
+ * Cada valor depende solo de la semilla y del índice pedido, por lo que el
+ * resultado es idéntico en cualquier plataforma y libc, y las celdas del
+ * tablero pueden generarse en cualquier orden o en bloques independientes.
+ * 
+ * @param seed Semilla del juego
+ * @param counter Índice del valor pedido
+ * @return 64 bits pseudoaleatorios
+ */
+uint64_t boardRandom(uint64_t seed, uint64_t counter);
+
+/**
+ * @brief Llena un bloque contiguo de celdas del tablero con valores entre 1 y 9
+ * 
+ * El cuerpo del bucle no tiene saltos ni dependencias entre iteraciones,
+ * lo que permite al compilador vectorizarlo.
+ * 
+ * @param tablero Tablero a llenar
+ * @param seed Semilla del juego
+ * @param from Primera celda del bloque
+ * @param to Celda siguiente a la última del bloque
+ */
+void fillBoardBlock(int *tablero, uint64_t seed, size_t from, size_t to);
+
+/**
+ * @brief Genera el tablero inicial a partir de la semilla
+ * 
+ * @param state Estado actual del juego
+ * @param seed Semilla del juego
+ */
+void generateBoard(game_state_t *state, unsigned int seed);
+
+/**
+ * @brief Establece las posiciones iniciales de los jugadores en el tablero
+ * 
+ * Coloca a los jugadores en posiciones distribuidas circularmente alrededor del centro
+ * del tablero, evitando que empiecen en la misma posición.
+ * 
+ * @param state Estado actual del juego
+ * @param seed Semilla del juego
+ */
+void setStartingPositions(game_state_t *state, unsigned int seed);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#define CACHE_LINE_SIZE 64
+
+/**
+ * @brief Semáforo contador en memoria compartida basado en futex
+ *
+ * Mientras haya fichas disponibles, tomar o entregar una no requiere
+ * llamadas al sistema. Solo se entra al kernel para dormir cuando no hay
+ * fichas, o para despertar cuando hay procesos esperando.
+ */
+typedef struct {
+    unsigned int value;   ///< Fichas disponibles
+    unsigned int waiters; ///< Procesos bloqueados esperando una ficha
+} futex_sem_t;
+
+/**
+ * @brief Buzón de un solo productor y un solo consumidor por jugador
+ *
+ * Cada dirección ocupa su propia línea de caché para que el jugador y el
+ * máster no se invaliden mutuamente al escribir.
+ */
+typedef struct {
+    // Jugador -> máster (escrita solo por el jugador)
+    unsigned int move_seq;   ///< Se incrementa al publicar un movimiento
+    unsigned char move;      ///< Último movimiento publicado
+    char _pad[CACHE_LINE_SIZE - sizeof(unsigned int) - sizeof(unsigned char)];
+
+    // Máster -> jugador (escrita solo por el máster)
+    futex_sem_t turn __attribute__((aligned(CACHE_LINE_SIZE))); ///< Fichas de turno
+    unsigned int consumed_seq; ///< Último move_seq procesado por el máster
+} __attribute__((aligned(CACHE_LINE_SIZE))) move_mailbox_t;
+
+/**
+ * @brief Toma una ficha del semáforo, bloqueando si no hay ninguna
+ *
+ * @param sem Semáforo a decrementar
+ * @param timeoutMs Tiempo máximo de espera en milisegundos, negativo para esperar indefinidamente
+ * @return 0 si se tomó una ficha, -1 si venció el tiempo de espera
+ */
+int futexSemWait(futex_sem_t *sem, int timeoutMs);
+
+/**
+ * @brief Entrega una ficha al semáforo, despertando a un proceso si hay alguno esperando
+ *
+ * @param sem Semáforo a incrementar
+ */
+void futexSemPost(futex_sem_t *sem);
+
+/**
+ * @brief Publica un movimiento en el buzón (lado del jugador)
+ *
+ * @param mailbox Buzón del jugador
+ * @param move Movimiento a publicar
+ */
+void mailboxPublish(move_mailbox_t *mailbox, unsigned char move);
+
+/**
+ * @brief Retira el movimiento pendiente del buzón, si lo hay (lado del máster)
+ *
+ * @param mailbox Buzón del jugador
+ * @param move Donde se guarda el movimiento retirado
+ * @return 1 si había un movimiento pendiente, 0 si no
+ */
+int mailboxConsume(move_mailbox_t *mailbox, unsigned char *move);
+
+#endif
@@ -3,15 +3,34 @@
 
 #include <structs.h>
 
+typedef struct reach_cache reach_cache_t;
+typedef int (*ponder_fn_t)(void *context);
+typedef double (*move_scorer_t)(game_state_t *state, unsigned short x, unsigned short y, int direction, void *context);
+
 game_state_t *getState();
 game_sync_t *getSync();
 void releaseState(game_state_t *state);
 void releaseSync(game_sync_t *sync);
 jugador_t *getPlayer(game_state_t *state, pid_t playerPid, int *playerListIndex);
 int freeNeighborCount(game_state_t *state, unsigned short x, unsigned short y);
+unsigned char legalMoves(game_state_t *state, unsigned short x, unsigned short y);
 char (*getMoveMap())[3];
 int squareDistanceToPlayer(game_state_t *state, int targetPlayerId, unsigned short fromX, unsigned short fromY);
 int sqrDistClosestOther(game_state_t *state, unsigned int callerId, unsigned short fromX, unsigned short fromY);
+void loadTuning(int argc, char *argv[]);
+double tuningParam(const char *name, double fallback);
+int stillPlaying(game_sync_t *sync, jugador_t *player);
+void enterReader(game_sync_t *sync);
+void exitReader(game_sync_t *sync);
+void awaitTurn(game_sync_t *sync, int playerListIndex);
+void awaitTurnPondering(game_sync_t *sync, int playerListIndex, ponder_fn_t ponder, void *context);
+void submitMove(game_sync_t *sync, int playerListIndex, unsigned char move);
 int bfsExplore(game_state_t *state, unsigned short x, unsigned short y, unsigned int maxDepth, int *exploredSpaces);
+reach_cache_t *createReachCache(unsigned int maxDepth);
+void syncReachCache(reach_cache_t *cache, game_state_t *state);
+int cachedBfsExplore(reach_cache_t *cache, game_state_t *state, unsigned short x, unsigned short y, int *exploredSpaces);
+int ponderReachCache(reach_cache_t *cache, game_state_t *state, unsigned short x, unsigned short y);
+void releaseReachCache(reach_cache_t *cache);
+unsigned char evaluateMoves(game_state_t *state, unsigned short x, unsigned short y, move_scorer_t scorer, void *context, double scores[8]);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef RATINGS_H
+#define RATINGS_H
+
+#include <structs.h>
+
+#define RATINGS_MAGIC 0x54524843u   // "CHRT"
+#define RATINGS_VERSION 1
+#define RATINGS_CAPACITY 256        // Binarios distintos que entran en un archivo
+#define RATING_INITIAL 1500.0
+#define RATING_K 32.0
+
+/**
+ * @brief Rating acumulado de un binario de jugador
+ */
+typedef struct {
+    char name[PLAYER_NAME_LENGTH];  ///< Nombre del jugador (basename del binario)
+    double rating;                  ///< Rating Elo
+    unsigned int games;             ///< Partidas jugadas
+    unsigned int wins;              ///< Partidas terminadas en primer lugar (empates incluidos)
+    unsigned long long score;       ///< Puntaje total acumulado
+} rating_entry_t;
+
+/**
+ * @brief Contenido del archivo de ratings, mapeado tal cual en memoria
+ *
+ * Las entradas nuevas se agregan al final, así que un índice no cambia
+ * nunca y el archivo se puede leer en cualquier momento con un lock compartido.
+ */
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int count;             ///< Entradas en uso
+    unsigned int capacity;          ///< Siempre RATINGS_CAPACITY
+    unsigned long long games;       ///< Partidas registradas en total
+    rating_entry_t entries[RATINGS_CAPACITY];
+} rating_store_t;
+
+/**
+ * @brief Archivo de ratings abierto
+ */
+typedef struct {
+    int fd;
+    rating_store_t *store;
+} ratings_t;
+
+/**
+ * @brief Abre (o crea) un archivo de ratings y lo mapea en memoria
+ *
+ * @param ratings Donde se guarda el archivo abierto
+ * @param path Ruta del archivo
+ * @param writable 1 para poder registrar partidas, 0 solo para leer
+ * @return 0 en éxito, -1 en error (con errno indicando la causa)
+ */
+int openRatings(ratings_t *ratings, const char *path, int writable);
+
+/**
+ * @brief Registra el resultado de una partida terminada
+ *
+ * Trata la partida multijugador como enfrentamientos entre cada par de
+ * jugadores según el ranking final (gana el de arriba, empate si
+ * comparePlayers da 0) y actualiza el Elo con K repartido entre los P-1
+ * rivales. Si varios asientos usan el mismo binario, no se enfrentan entre
+ * sí y la entrada se actualiza una sola vez: suma los cambios de rating de
+ * todos sus asientos, pero partidas, puntaje y victorias salen solo de su
+ * asiento mejor ubicado. Toma un lock exclusivo sobre el archivo, así que
+ * varios másters pueden registrar partidas a la vez.
+ *
+ * @param ratings Archivo abierto con writable = 1
+ * @param state Estado de la partida terminada, con su ranking
+ * @return 0 en éxito, -1 si no se pudo tomar el lock
+ */
+int recordGame(ratings_t *ratings, game_state_t *state);
+
+/**
+ * @brief Toma o libera un lock compartido para leer un resultado consistente
+ *
+ * @param ratings Archivo abierto
+ * @param locked 1 para tomar el lock, 0 para liberarlo
+ */
+void lockRatings(ratings_t *ratings, int locked);
+
+/**
+ * @brief Desmapea y cierra un archivo de ratings
+ *
+ * @param ratings Archivo abierto
+ */
+void closeRatings(ratings_t *ratings);
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include <structs.h>
+
+/**
+ * @brief Opciones de la vista general para tableros más grandes que la terminal
+ */
+typedef struct {
+    int cols;       ///< Columnas de caracteres disponibles
+    int rows;       ///< Filas de caracteres disponibles; cada una muestra dos filas de píxeles
+    int follow;     ///< Jugador que sigue la ventana, -1 para mostrar todo el tablero
+    int viewport;   ///< Lado en celdas de la ventana que sigue al jugador
+} overview_t;
+
+/**
+ * @brief Imprime una barra de progreso animada para indicar que el juego está corriendo
+ * 
+ * Crea un indicador visual de que el juego está ejecutándose activamente mostrando
+ * una barra con un carácter móvil que cicla a través de las posiciones.
+ * 
+ * @param length La longitud de la barra animada
+ * @param frame El número de frame actual para la animación
+ */
+void printAnimatedBar(int length, int frame);
+
+/**
+ * @brief Imprime una barra decorativa para la pantalla de fin de juego
+ * 
+ * Crea una barra separadora visual usando signos iguales para la pantalla final del juego.
+ * 
+ * @param length La longitud de la barra a imprimir
+ */
+void printEndgameBar(int length);
+
+/**
+ * @brief Dibuja el tablero de juego con posiciones actuales de jugadores y celdas visitadas
+ * 
+ * Renderiza el tablero de juego mostrando:
+ * - Posiciones actuales de jugadores como letras coloreadas (A, B, C, etc.)
+ * - Celdas previamente visitadas como puntos coloreados
+ * - Celdas no visitadas como sus valores numéricos
+ * 
+ * @param state Puntero al estado actual del juego
+ */
+void drawBoard(game_state_t *state);
+
+/**
+ * @brief Dibuja el tablero reducido a una vista general de tamaño fijo
+ * 
+ * Cada carácter es un medio bloque con dos píxeles. Un píxel toma el color
+ * del jugador dueño de la mayoría de sus celdas, o un gris según el valor
+ * libre promedio. Los píxeles se calculan con los agregados por bloque del
+ * estado, así que el costo depende del tamaño de la vista y no del tablero.
+ * Las posiciones actuales se marcan con la letra del jugador.
+ * 
+ * @param state Puntero al estado actual del juego
+ * @param overview Tamaño de la vista y jugador a seguir
+ */
+void drawOverview(game_state_t *state, const overview_t *overview);
+
+/**
+ * @brief Columnas de caracteres que ocupa la vista general
+ * 
+ * Pueden ser menos que las pedidas, ya que el tablero no se deforma.
+ * 
+ * @param state Puntero al estado actual del juego
+ * @param overview Tamaño de la vista y jugador a seguir
+ * @return Columnas que dibuja drawOverview
+ */
+int overviewColumns(game_state_t *state, const overview_t *overview);
+
+/**
+ * @brief Imprime el estado actual del juego y la tabla de posiciones
+ * 
+ * Muestra una tabla de posiciones formateada con todos los jugadores ordenados por puntaje,
+ * incluyendo sus nombres, puntajes, posiciones y estado de bloqueo.
+ * 
+ * @param state Puntero al estado actual del juego
+ * @param title Título a mostrar encima de la tabla de posiciones
+ */
+void printStatus(game_state_t *state, char *title);
+
+/**
+ * @brief Muestra el estado final del juego y el ganador
+ * 
+ * Muestra la tabla de posiciones final, el tablero de juego, y anuncia el ganador
+ * con el puntaje más alto.
+ * 
+ * @param state Puntero al estado actual del juego
+ * @param overview Vista general a usar para el tablero, NULL para dibujarlo completo
+ */
+void gameEnded(game_state_t *state, const overview_t *overview);
+
+#endif
\ No newline at end of file
@@ -15,6 +15,32 @@
  */
 int *getPlayerOrder(game_state_t *state);
 
+/**
+ * @brief Compara dos jugadores según el criterio de desempate del juego
+ * 
+ * @param j1 Primer jugador
+ * @param j2 Segundo jugador
+ * @return Positivo si j1 va antes que j2, negativo si va después, 0 si empatan
+ */
 int comparePlayers(jugador_t j1, jugador_t j2);
 
+/**
+ * @brief Ordena desde cero el ranking del estado
+ * 
+ * @param state Estado del juego con los jugadores ya inicializados
+ */
+void initRanking(game_state_t *state);
+
+/**
+ * @brief Reubica a un jugador en el ranking después de cambiar sus contadores
+ * 
+ * Busca binariamente la nueva posición entre los demás, que siguen ordenados,
+ * y desplaza solo el tramo intermedio. Los lectores usan state->ranking sin
+ * ordenar ni reservar memoria.
+ * 
+ * @param state Estado del juego
+ * @param playerId ID del jugador cuyo puntaje o cantidad de movimientos cambió
+ */
+void updateRanking(game_state_t *state, int playerId);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,120 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define SESSION_ENV "CHOMP_SESSION"
+#define SHM_NAME_LENGTH 64
+
+// Opciones de mapeo de los segmentos, como lista separada por comas ("prefault,huge,lock")
+#define SHM_OPTIONS_ENV "CHOMP_SHM"
+#define SHM_HUGE_PAGE_SIZE (2UL * 1024 * 1024)
+
+#define SHM_PREFAULT 1   ///< Cargar todas las páginas al mapear
+#define SHM_HUGEPAGES 2  ///< Pedir páginas grandes transparentes para el segmento
+#define SHM_MLOCK 4      ///< Fijar el segmento en memoria
+
+/**
+ * @brief Arma el nombre de un segmento compartido para la sesión actual
+ *
+ * Si CHOMP_SESSION está definida, se agrega como sufijo para que varios
+ * másters (por ejemplo, los del tuner) corran en paralelo sin pisarse.
+ * Los procesos hijos heredan la variable y abren los mismos segmentos.
+ *
+ * @param base Nombre base del segmento, como "/game_state"
+ * @param name Donde se guarda el nombre completo
+ * @return name, para poder usarlo directamente en shm_open
+ */
+static inline const char *sessionShmName(const char *base, char name[SHM_NAME_LENGTH]) {
+    const char *session = getenv(SESSION_ENV);
+    if (session != NULL && *session != '\0') {
+        snprintf(name, SHM_NAME_LENGTH, "%s_%s", base, session);
+    } else {
+        snprintf(name, SHM_NAME_LENGTH, "%s", base);
+    }
+    return name;
+}
+
+/**
+ * @brief Lee las opciones de mapeo de la sesión
+ *
+ * Se toman de CHOMP_SHM, que el máster exporta a partir de sus opciones
+ * para que la vista y los jugadores mapeen los segmentos de la misma forma.
+ *
+ * @return Combinación de SHM_PREFAULT, SHM_HUGEPAGES y SHM_MLOCK
+ */
+static inline int sessionShmOptions(void) {
+    const char *value = getenv(SHM_OPTIONS_ENV);
+    int options = 0;
+    if (value == NULL) return 0;
+    if (strstr(value, "prefault") != NULL) options |= SHM_PREFAULT;
+    if (strstr(value, "huge") != NULL) options |= SHM_HUGEPAGES;
+    if (strstr(value, "lock") != NULL) options |= SHM_MLOCK;
+    return options;
+}
+
+/**
+ * @brief Tamaño con el que se crea y mapea un segmento
+ *
+ * Con páginas grandes se redondea a un múltiplo de SHM_HUGE_PAGE_SIZE, ya
+ * que el kernel solo usa una página grande si el mapeo la cubre entera.
+ *
+ * @param size Tamaño de la estructura compartida
+ * @param options Opciones de mapeo
+ * @return Tamaño del segmento
+ */
+static inline size_t sessionShmSize(size_t size, int options) {
+    if (options & SHM_HUGEPAGES) {
+        return (size + SHM_HUGE_PAGE_SIZE - 1) & ~(SHM_HUGE_PAGE_SIZE - 1);
+    }
+    return size;
+}
+
+/**
+ * @brief Mapea un segmento compartido aplicando las opciones de la sesión
+ *
+ * Las páginas grandes se piden con madvise antes de cargar nada, ya que
+ * shm_open vive en tmpfs y no admite MAP_HUGETLB; el kernel las usa si
+ * shmem_enabled de transparent_hugepage lo permite. Si no se pueden fijar
+ * las páginas en memoria solo se avisa, el mapeo sigue siendo válido.
+ *
+ * @param fd Descriptor del segmento
+ * @param size Tamaño devuelto por sessionShmSize
+ * @param prot Protección del mapeo
+ * @param options Opciones de mapeo
+ * @return Dirección del mapeo, o MAP_FAILED en error
+ */
+static inline void *mapSessionSegment(int fd, size_t size, int prot, int options) {
+    void *addr = mmap(NULL, size, prot, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) return addr;
+
+#ifdef MADV_HUGEPAGE
+    if (options & SHM_HUGEPAGES) {
+        madvise(addr, size, MADV_HUGEPAGE);
+    }
+#endif
+    if (options & SHM_PREFAULT) {
+        int populated = -1;
+#ifdef MADV_POPULATE_WRITE
+        populated = madvise(addr, size, (prot & PROT_WRITE) ? MADV_POPULATE_WRITE : MADV_POPULATE_READ);
+#endif
+        if (populated != 0) {
+            // Kernels sin MADV_POPULATE_*: tocar una vez cada página
+            long page = sysconf(_SC_PAGESIZE);
+            volatile const char *bytes = addr;
+            for (size_t offset = 0; offset < size; offset += page) {
+                (void)bytes[offset];
+            }
+        }
+    }
+    if ((options & SHM_MLOCK) && mlock(addr, size) != 0) {
+        perror("mlock");
+    }
+    return addr;
+}
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef SPECTATE_H
+#define SPECTATE_H
+
+#include <structs.h>
+
+#define SPECTATE_MAX_CLIENTS 16
+#define SPECTATE_BUFFER_SIZE (128 * 1024)   // Cola por espectador; entra siempre una foto completa
+
+// Tipos de mensaje del flujo
+#define SPECTATE_SNAPSHOT 1   // Foto completa: spectate_snapshot_t seguido del tablero
+#define SPECTATE_PLAYER 2     // Cambio de un jugador: spectate_player_t
+#define SPECTATE_END 3        // Terminó la partida, sin contenido
+
+/**
+ * @brief Encabezado de cada mensaje del flujo de espectadores
+ *
+ * El socket es local, así que todo viaja en el orden de bytes del host.
+ */
+typedef struct {
+    unsigned int type;    ///< SPECTATE_*
+    unsigned int length;  ///< Bytes de contenido que siguen al encabezado
+} spectate_header_t;
+
+/**
+ * @brief Foto completa de la partida, seguida de width * height enteros del tablero
+ *
+ * Se manda al conectarse, al empezar cada partida y cuando un espectador
+ * lento se queda sin lugar en su cola y hay que resincronizarlo.
+ */
+typedef struct {
+    unsigned int game;                          ///< Partida dentro de la sesión
+    unsigned short width;
+    unsigned short height;
+    unsigned int num_jugadores;
+    int terminado;
+    jugador_t jugadores[MAX_JUGADORES];
+    unsigned char ranking[MAX_JUGADORES];       ///< IDs ordenados, mejor primero
+} spectate_snapshot_t;
+
+/**
+ * @brief Cambio en un jugador: movimiento, jugada inválida o bonificación
+ *
+ * Si captured es 1, el jugador se movió a (row.x, row.y) y esa celda pasa
+ * a valer -player en el tablero. El ranking viaja completo porque cualquier
+ * cambio de puntaje puede reordenarlo.
+ */
+typedef struct {
+    unsigned char player;
+    unsigned char captured;
+    unsigned char ranking[MAX_JUGADORES];
+    jugador_t row;                              ///< Fila completa del jugador tras el cambio
+} spectate_player_t;
+
+/**
+ * @brief Espectador conectado y su cola de salida
+ */
+typedef struct {
+    int fd;
+    int resync;                                 ///< 1 si se descartaron cambios y espera una foto nueva
+    size_t used;                                ///< Bytes en cola sin enviar
+    char buffer[SPECTATE_BUFFER_SIZE];
+} spectator_t;
+
+/**
+ * @brief Servidor de espectadores del máster
+ */
+typedef struct {
+    int listen_fd;                              ///< -1 si no se pidió servir espectadores
+    char path[108];
+    unsigned int game;
+    spectator_t *clients[SPECTATE_MAX_CLIENTS];
+    unsigned long long resyncs;                 ///< Veces que se resincronizó a un espectador lento
+    unsigned long long dropped;                 ///< Espectadores desconectados por error
+} spectators_t;
+
+/**
+ * @brief Abre el socket de espectadores
+ *
+ * Si path es NULL el servidor queda deshabilitado y el resto de las
+ * funciones no hacen nada.
+ *
+ * @param spectators Servidor a inicializar
+ * @param path Ruta del socket Unix (se reemplaza si ya existe)
+ * @return 0 en éxito, -1 en error (con errno indicando la causa)
+ */
+int openSpectators(spectators_t *spectators, const char *path);
+
+/**
+ * @brief Anuncia el comienzo de una partida mandando una foto a todos
+ *
+ * @param spectators Servidor de espectadores
+ * @param state Estado de la partida recién preparada
+ * @param game Partida dentro de la sesión
+ */
+void spectateGame(spectators_t *spectators, const game_state_t *state, unsigned int game);
+
+/**
+ * @brief Publica el cambio de un jugador
+ *
+ * Nunca bloquea: a un espectador sin lugar en su cola se le descartan los
+ * cambios hasta que la vacíe, y ahí recibe una foto nueva.
+ *
+ * @param spectators Servidor de espectadores
+ * @param state Estado ya actualizado
+ * @param playerId ID del jugador que cambió
+ * @param captured 1 si el jugador se movió y capturó la celda donde está
+ */
+void spectateUpdate(spectators_t *spectators, const game_state_t *state, int playerId, int captured);
+
+/**
+ * @brief Publica el fin de la partida
+ *
+ * @param spectators Servidor de espectadores
+ * @param state Estado final
+ */
+void spectateEnd(spectators_t *spectators, const game_state_t *state);
+
+/**
+ * @brief Envía lo que quede en cola, desconecta a todos y borra el socket
+ *
+ * @param spectators Servidor de espectadores
+ */
+void closeSpectators(spectators_t *spectators);
+
+#endif
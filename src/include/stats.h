@@ -0,0 +1,40 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <sys/types.h>
+
+#define STATS_SHM_NAME "/game_stats"
+
+/**
+ * @brief Contadores que publica el máster en su segmento de estadísticas
+ *
+ * Solo el máster escribe; los lectores (chompstat) toman muestras periódicas
+ * y calculan tasas por diferencia, por lo que no hace falta sincronización.
+ */
+typedef struct {
+    int running;                         ///< 1 mientras el máster está jugando
+    pid_t master_pid;                    ///< PID del máster que publica
+    unsigned int players_active;         ///< Jugadores activos en la partida actual
+    unsigned int games_played;           ///< Partidas terminadas en la sesión
+    unsigned long long moves;            ///< Movimientos procesados (válidos + inválidos)
+    unsigned long long valid_moves;      ///< Movimientos válidos
+    unsigned long long invalid_moves;    ///< Movimientos inválidos
+    unsigned long long polls;            ///< Llamadas a select o revisiones de buzones
+    unsigned long long wakeups;          ///< Revisiones que encontraron al menos un movimiento
+    unsigned long long lock_wait_ns;     ///< Tiempo bloqueado tomando game_state_mutex
+    unsigned long long view_wait_ns;     ///< Tiempo bloqueado en view_done_signal
+    unsigned long long ticks;            ///< Iteraciones del bucle principal
+    unsigned long long tick_ns;          ///< Duración acumulada de las iteraciones
+} master_stats_t;
+
+/**
+ * @brief Suma a un contador con un único escritor sin instrucciones con lock
+ *
+ * @param counter Contador a incrementar
+ * @param amount Cantidad a sumar
+ */
+static inline void statAdd(unsigned long long *counter, unsigned long long amount) {
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + amount, __ATOMIC_RELAXED);
+}
+
+#endif
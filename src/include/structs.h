@@ -4,12 +4,21 @@
 #include <stdlib.h>
 #include <sys/types.h>
 #include <semaphore.h>
+#include <mailbox.h>
 
 #define PLAYER_NAME_LENGTH 16
 #define MAX_JUGADORES 9
 #define MAX_WIDTH 100
 #define MAX_HEIGHT 100
 
+// Bloques de TILE_SIZE x TILE_SIZE celdas con agregados para dibujar tableros grandes
+#define TILE_SIZE 4
+#define TILE_COLS ((MAX_WIDTH + TILE_SIZE - 1) / TILE_SIZE)
+#define TILE_ROWS ((MAX_HEIGHT + TILE_SIZE - 1) / TILE_SIZE)
+
+#define TRANSPORT_PIPE 0    // Movimientos por pipe y fichas con sem_t
+#define TRANSPORT_MAILBOX 1 // Movimientos y fichas por buzones en memoria compartida
+
 typedef struct {
     char nombre[PLAYER_NAME_LENGTH];
     unsigned int puntaje;
@@ -25,8 +34,16 @@ typedef struct {
     unsigned short height;
     unsigned int num_jugadores;
     jugador_t jugadores[MAX_JUGADORES];
+    int ranking[MAX_JUGADORES]; // IDs de jugadores ordenados por comparePlayers (mejor primero), mantenido por el máster
     int terminado;
+    unsigned int game; // Generación de partida: setup_game la incrementa al empezar y al terminar (impar = preparando)
     int tablero[MAX_WIDTH * MAX_HEIGHT];
+    // Tablas derivadas del tablero, mantenidas por el máster en cada captura
+    unsigned char free_neighbors[MAX_WIDTH * MAX_HEIGHT]; // Cantidad de vecinos libres de cada celda
+    unsigned char legal_moves[MAX_WIDTH * MAX_HEIGHT]; // Bit d encendido si el vecino en la dirección d está libre
+    // Agregados por bloque (índice (y / TILE_SIZE) * TILE_COLS + x / TILE_SIZE), mantenidos por el máster en cada captura
+    unsigned short tile_free_value[TILE_ROWS * TILE_COLS]; // Suma de los valores libres del bloque
+    unsigned char tile_owned[TILE_ROWS * TILE_COLS][MAX_JUGADORES]; // Celdas del bloque capturadas por cada jugador
 } game_state_t;
 
 typedef struct {
@@ -37,6 +54,10 @@ typedef struct {
     sem_t reader_count_mutex; // Mutex para la siguiente variable
     unsigned int active_readers_count; // Cantidad de jugadores leyendo el estado
     sem_t player_move_token[9]; // Le indican a cada jugador que puede enviar 1 movimiento
+    int transport; // TRANSPORT_PIPE o TRANSPORT_MAILBOX, elegido por el máster
+    int more_games; // Quedan partidas en la sesión: jugadores y vista no deben terminar
+    futex_sem_t master_doorbell; // Los jugadores avisan al máster que publicaron un movimiento
+    move_mailbox_t mailboxes[MAX_JUGADORES]; // Un buzón por jugador (solo con TRANSPORT_MAILBOX)
 } game_sync_t;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#define TRACE_ENV "CHOMP_TRACE"
+
+/**
+ * @brief Activa el trazado si la variable de entorno CHOMP_TRACE indica un archivo
+ *
+ * Los eventos se agregan a ese archivo en formato Chrome trace-event (JSON),
+ * un evento por línea, usando el reloj monótono compartido por todos los
+ * procesos. Si la variable no está definida el trazado queda desactivado y
+ * las demás funciones no hacen nada.
+ *
+ * @param role Rol del proceso (master, vista, jugador) para nombrarlo en el timeline
+ */
+void traceInit(const char *role);
+
+/**
+ * @brief Indica si el trazado está activo
+ *
+ * @return 1 si está activo, 0 si no
+ */
+int traceEnabled();
+
+/**
+ * @brief Retorna el instante actual para marcar el inicio de una fase
+ *
+ * @return Nanosegundos del reloj monótono, o 0 si el trazado está desactivado
+ */
+unsigned long long traceNow();
+
+/**
+ * @brief Registra una fase que empezó en start y termina ahora
+ *
+ * @param name Nombre de la fase
+ * @param start Valor retornado por traceNow() al empezar la fase
+ */
+void traceSpan(const char *name, unsigned long long start);
+
+/**
+ * @brief Crea el archivo de traza vacío (lo llama el máster antes de lanzar procesos)
+ *
+ * @param path Ruta del archivo de traza
+ * @return 0 en éxito, -1 en error
+ */
+int traceCreate(const char *path);
+
+/**
+ * @brief Cierra el arreglo JSON del archivo de traza (lo llama el máster al final)
+ */
+void traceFinish();
+
+#endif
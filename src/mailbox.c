@@ -0,0 +1,69 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _DEFAULT_SOURCE
+#include <mailbox.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// Sin FUTEX_PRIVATE_FLAG: los futex viven en memoria compartida entre procesos
+static int futexWait(unsigned int *addr, unsigned int expected, int timeoutMs) {
+    struct timespec ts;
+    struct timespec *tsp = NULL;
+    if (timeoutMs >= 0) {
+        ts.tv_sec = timeoutMs / 1000;
+        ts.tv_nsec = (long)(timeoutMs % 1000) * 1000000L;
+        tsp = &ts;
+    }
+    return syscall(SYS_futex, addr, FUTEX_WAIT, expected, tsp, NULL, 0);
+}
+
+static void futexWake(unsigned int *addr, int count) {
+    syscall(SYS_futex, addr, FUTEX_WAKE, count, NULL, NULL, 0);
+}
+
+int futexSemWait(futex_sem_t *sem, int timeoutMs) {
+    for (;;) {
+        unsigned int value = __atomic_load_n(&sem->value, __ATOMIC_ACQUIRE);
+        while (value > 0) {
+            if (__atomic_compare_exchange_n(&sem->value, &value, value - 1, 0,
+                                            __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+                return 0;
+            }
+        }
+
+        __atomic_fetch_add(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+        int result = futexWait(&sem->value, 0, timeoutMs);
+        int error = errno;
+        __atomic_fetch_sub(&sem->waiters, 1, __ATOMIC_SEQ_CST);
+
+        if (result == -1 && error == ETIMEDOUT) {
+            return -1;
+        }
+    }
+}
+
+void futexSemPost(futex_sem_t *sem) {
+    __atomic_fetch_add(&sem->value, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&sem->waiters, __ATOMIC_SEQ_CST) > 0) {
+        futexWake(&sem->value, 1);
+    }
+}
+
+void mailboxPublish(move_mailbox_t *mailbox, unsigned char move) {
+    mailbox->move = move;
+    // El release garantiza que el máster vea el movimiento antes que la secuencia
+    __atomic_fetch_add(&mailbox->move_seq, 1, __ATOMIC_RELEASE);
+}
+
+int mailboxConsume(move_mailbox_t *mailbox, unsigned char *move) {
+    unsigned int seq = __atomic_load_n(&mailbox->move_seq, __ATOMIC_ACQUIRE);
+    if (seq == mailbox->consumed_seq) {
+        return 0;
+    }
+    *move = mailbox->move;
+    mailbox->consumed_seq = seq;
+    return 1;
+}
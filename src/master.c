@@ -26,11 +26,23 @@
 #include <time.h>
 #include <getopt.h>
 #include <string.h>
+#include <ctype.h>
+#include <errno.h>
 #include <sys/select.h>
 #include <signal.h>
+#include <sys/file.h>
+#include <sys/resource.h>
 #include <structs.h>
 #include <score.h>
-#include <math.h>
+#include <mailbox.h>
+#include <game.h>
+#include <stats.h>
+#include <trace.h>
+#include <session.h>
+#include <ratings.h>
+#include <affinity.h>
+#include <spectate.h>
+#include <boardfile.h>
 
 // Constantes de configuración del juego
 #define MAX_JUGADORES 9
@@ -44,6 +56,31 @@
 #define DEFAULT_HEIGHT 10
 #define DEFAULT_DELAY 200
 #define DEFAULT_TIMEOUT 1
+#define DEFAULT_GAMES 1
+#define DEFAULT_BOUND_PERCENT 100
+#define DEFAULT_IDLE_ROUNDS 100
+#define MAX_PLAYER_ARGS 16
+
+// Resultados de esperar un movimiento en lockstep, además del movimiento
+#define MOVE_DISCONNECTED -1
+#define MOVE_TIMED_OUT -2
+
+#define EXIT_POLL_MS 50  // Cada cuánto se revisa con buzones si un jugador terminó
+
+// Valores de las opciones largas sin equivalente corto
+#define OPT_PIN_MASTER 1000
+#define OPT_PIN_VIEW 1001
+#define OPT_PIN_PLAYERS 1002
+#define OPT_MASTER_NICE 1003
+#define OPT_PREFAULT 1004
+#define OPT_HUGEPAGES 1005
+#define OPT_MLOCK 1006
+#define OPT_SPECTATE 1007
+
+// Resolución anticipada cuando ninguna región libre es disputada
+#define EARLY_END_NONE 0   // Jugar hasta el final normalmente
+#define EARLY_END_RUN 1    // Seguir jugando sin delay ni sincronización con la vista
+#define EARLY_END_BOUND 2  // Terminar acreditando a cada jugador una cota de su región
 
 /**
  * @brief Estructura para parámetros de configuración del juego
@@ -56,9 +93,75 @@ typedef struct {
     unsigned int seed;                            ///< Semilla para generación aleatoria
     char *view_path;                              ///< Ruta del binario de la vista
     char *player_paths[MAX_JUGADORES];            ///< Rutas de los binarios de jugadores
+    char *player_args[MAX_JUGADORES][MAX_PLAYER_ARGS + 2]; ///< argv de cada jugador (argv[0] se completa al lanzar)
     int num_players;                              ///< Número de jugadores
+    int use_mailbox;                              ///< Usar buzones en memoria compartida en lugar de pipes
+    int games;                                    ///< Partidas a jugar reutilizando los mismos procesos
+    int early_end;                                ///< Modo de resolución anticipada (EARLY_END_*)
+    int bound_percent;                            ///< Porcentaje de la región acreditado con EARLY_END_BOUND
+    int lockstep;                                 ///< Turnos deterministas sin pausas ni sincronización con la vista
+    int idle_rounds;                              ///< Rondas sin movimientos válidos que terminan una partida lockstep
+    char *trace_path;                             ///< Archivo de traza Chrome trace-event (NULL = sin traza)
+    char *ratings_path;                           ///< Archivo de ratings Elo a actualizar (NULL = sin ratings)
+    char *metrics_path;                           ///< Archivo CSV de métricas por partida (NULL = sin métricas)
+    int move_deadline;                            ///< Milisegundos libres por movimiento desde la ficha (0 = sin plazo)
+    int time_bank;                                ///< Reserva en milisegundos por partida para exceder el plazo
+    cpu_list_t pin_master;                        ///< CPUs del máster (vacía = sin fijar)
+    cpu_list_t pin_view;                          ///< CPUs de la vista (vacía = sin fijar)
+    cpu_list_t pin_players;                       ///< CPUs de los jugadores, una por jugador en ronda
+    int master_nice;                              ///< Valor nice del máster (negativo = más prioridad)
+    int set_master_nice;                          ///< 1 si se pidió cambiar la prioridad del máster
+    int shm_options;                              ///< Opciones de mapeo pedidas (SHM_PREFAULT, SHM_HUGEPAGES, SHM_MLOCK)
+    char *spectate_path;                          ///< Socket Unix para espectadores (NULL = sin espectadores)
+    char *board_import_path;                      ///< Archivo de tableros a jugar en lugar de generarlos (-i)
+    char *board_export_path;                      ///< Archivo al que agregar los tableros generados (-x)
 } config_t;
 
+// Estadísticas publicadas; apuntan a una copia local si no hay segmento compartido
+static master_stats_t local_stats;
+static master_stats_t *g_stats = &local_stats;
+
+// Espectadores conectados por socket; sin socket todas las llamadas vuelven enseguida
+static spectators_t g_spectators = {.listen_fd = -1};
+
+// Tableros importados con -i (header NULL = generar con la semilla) y archivo de exportación de -x
+static board_file_t g_boards = {-1, NULL, 0};
+static int g_board_export_fd = -1;
+
+/**
+ * @brief Métricas de un jugador en la partida en curso, para el CSV de -o
+ */
+typedef struct {
+    unsigned long long token_ns;    ///< Momento en que se entregó la última ficha (0 = ninguna pendiente)
+    unsigned long long latency_ns;  ///< Suma de demoras entre ficha y movimiento recibido
+    unsigned int latency_samples;   ///< Movimientos medidos
+    int stuck_tick;                 ///< Movimientos de la partida al quedar atascado, -1 si no se atascó
+} player_metrics_t;
+
+static player_metrics_t g_metrics[MAX_JUGADORES];
+static unsigned int g_game_moves = 0; // Movimientos aplicados en la partida en curso
+
+/**
+ * @brief Reloj de un jugador con plazo por movimiento y reserva (-D / -B)
+ */
+typedef struct {
+    long long bank_ns;  ///< Reserva que queda en la partida
+    int overdue;        ///< 1 si ya se penalizó el movimiento pendiente por no llegar a tiempo
+} player_clock_t;
+
+static player_clock_t g_clocks[MAX_JUGADORES];
+
+/**
+ * @brief Consumo de recursos de un jugador en toda la sesión
+ */
+typedef struct {
+    unsigned long long valid_moves; ///< Movimientos válidos sumados en todas las partidas
+    struct rusage usage;            ///< Uso informado por wait4 al recolectar el proceso
+    int reaped;                     ///< 1 si el proceso ya se recolectó
+} player_usage_t;
+
+static player_usage_t g_usage[MAX_JUGADORES];
+
 // -----------------------
 
 /**
@@ -73,12 +176,93 @@ void show_help(const char *program_name) {
     printf("  -h height   Alto del tablero (default: %d, mínimo: %d)\n", DEFAULT_HEIGHT, MIN_HEIGHT);
     printf("  -d delay    Milisegundos entre impresiones (default: %d)\n", DEFAULT_DELAY);
     printf("  -t timeout  Timeout en segundos para movimientos (default: %d)\n", DEFAULT_TIMEOUT);
-    printf("  -s seed     Semilla para generación del tablero (default: time(NULL))\n");
+    printf("  -s seed     Semilla para generación del tablero, o primer tablero con -i (default: time(NULL))\n");
     printf("  -v view     Ruta del binario de la vista (default: sin vista)\n");
+    printf("  -g games    Partidas consecutivas con los mismos procesos (default: %d)\n", DEFAULT_GAMES);
+    printf("  -e mode     Resolver antes si ninguna región es disputada: run | bound (default: no)\n");
+    printf("  -b percent  Porcentaje del valor de la región acreditado con -e bound (default: %d)\n", DEFAULT_BOUND_PERCENT);
+    printf("  -l          Modo lockstep: turnos en orden fijo, sin delay ni vista intermedia\n");
+    printf("  -k rounds   Rondas sin movimientos válidos antes de terminar en lockstep (default: %d)\n", DEFAULT_IDLE_ROUNDS);
+    printf("  -T file     Escribir una traza Chrome/Perfetto de máster, vista y jugadores\n");
+    printf("  -r file     Acumular ratings Elo por binario en un archivo compartido (ver chomprank)\n");
+    printf("  -o file     Agregar métricas por partida y jugador en CSV a un archivo\n");
+    printf("  -i file     Jugar los tableros y posiciones de un archivo de tableros, en ronda\n");
+    printf("              El tamaño sale del archivo, así que no se combina con -w ni -h\n");
+    printf("  -x file     Agregar el tablero inicial de cada partida a un archivo de tableros\n");
+    printf("  -D ms       Plazo por movimiento desde que se entrega la ficha (default: sin plazo)\n");
+    printf("  -B ms       Reserva por partida para exceder el plazo, como un reloj de ajedrez (default: 0)\n");
+    printf("              Sin reserva, el movimiento se descarta como inválido (no aplica en lockstep)\n");
+    printf("  -m          Usar buzones en memoria compartida en lugar de pipes\n");
     printf("  -p players  Rutas de los binarios de los jugadores (mínimo: %d, máximo: %d)\n", MIN_JUGADORES, MAX_JUGADORES);
+    printf("              \"ruta NOMBRE=valor ...\" pasa parámetros de ajuste como argumentos\n");
+    printf("  --pin-master cpus   Fijar el máster a CPUs, como \"0\" o \"0,2-3\"\n");
+    printf("  --pin-view cpus     Fijar la vista a CPUs\n");
+    printf("  --pin-players cpus  Fijar cada jugador a una CPU de la lista, en ronda\n");
+    printf("  --master-nice n     Prioridad del máster (negativo = más prioridad, requiere permisos)\n");
+    printf("  --prefault          Cargar las páginas de la memoria compartida al mapearla\n");
+    printf("  --hugepages         Pedir páginas grandes para el estado del juego\n");
+    printf("  --mlock             Fijar la memoria compartida en RAM en todos los procesos\n");
+    printf("  --spectate path     Transmitir la partida a espectadores por un socket Unix (ver chompwatch)\n");
     printf("  --help      Mostrar esta ayuda\n");
 }
 
+/**
+ * @brief Indica si una palabra tiene la forma NOMBRE=valor
+ * 
+ * @param word Palabra a revisar
+ * @return 1 si empieza con letras, dígitos o '_' seguidos de '=', 0 si no
+ */
+int is_tuning_arg(const char *word) {
+    const char *p = word;
+    while (isalnum((unsigned char)*p) || *p == '_') p++;
+    return p != word && *p == '=';
+}
+
+/**
+ * @brief Separa la ruta de un jugador de los argumentos que la siguen
+ * 
+ * Un jugador puede indicarse como "ruta NOMBRE=valor ...": la ruta queda en
+ * player_paths y el resto se le pasa al jugador como argumentos. Solo se
+ * separan las palabras finales con forma NOMBRE=valor, así que una ruta con
+ * espacios sigue funcionando.
+ * 
+ * @param config Configuración con la especificación del jugador
+ * @param index Índice del jugador
+ * @return 0 en éxito, -1 si hay demasiados argumentos
+ */
+int split_player_spec(config_t *config, int index) {
+    char **args = config->player_args[index];
+    char *spec = config->player_paths[index];
+    char *found[MAX_PLAYER_ARGS];
+    int count = 0;
+
+    // Desde el final: cada palabra NOMBRE=valor se corta y la ruta se achica
+    size_t end = strlen(spec);
+    for (;;) {
+        while (end > 0 && spec[end - 1] == ' ') spec[--end] = '\0';
+        size_t start = end;
+        while (start > 0 && spec[start - 1] != ' ') start--;
+        if (start == 0 || !is_tuning_arg(spec + start)) break;
+        if (count == MAX_PLAYER_ARGS) {
+            fprintf(stderr, "Error: máximo %d argumentos por jugador\n", MAX_PLAYER_ARGS);
+            return -1;
+        }
+        found[count++] = spec + start;
+        end = start;
+    }
+    if (end == 0) {
+        fprintf(stderr, "Error: ruta de jugador vacía\n");
+        return -1;
+    }
+
+    // args[0] es el nombre del proceso; los argumentos van en el orden original
+    for (int i = 0; i < count; i++) {
+        args[1 + i] = found[count - 1 - i];
+    }
+    args[1 + count] = NULL;
+    return 0;
+}
+
 /**
  * @brief Parsea los argumentos de línea de comandos
  * 
@@ -96,6 +280,26 @@ int parse_arguments(int argc, char *argv[], config_t *config) {
     config->seed = time(NULL);
     config->view_path = NULL;
     config->num_players = 0;
+    config->use_mailbox = 0;
+    config->games = DEFAULT_GAMES;
+    config->early_end = EARLY_END_NONE;
+    config->bound_percent = DEFAULT_BOUND_PERCENT;
+    config->lockstep = 0;
+    config->idle_rounds = DEFAULT_IDLE_ROUNDS;
+    config->trace_path = NULL;
+    config->ratings_path = NULL;
+    config->metrics_path = NULL;
+    config->move_deadline = 0;
+    config->time_bank = 0;
+    config->pin_master.count = 0;
+    config->pin_view.count = 0;
+    config->pin_players.count = 0;
+    config->master_nice = 0;
+    config->set_master_nice = 0;
+    config->shm_options = 0;
+    config->spectate_path = NULL;
+    config->board_import_path = NULL;
+    config->board_export_path = NULL;
     
     for (int i = 0; i < MAX_JUGADORES; i++) {
         config->player_paths[i] = NULL;
@@ -103,16 +307,26 @@ int parse_arguments(int argc, char *argv[], config_t *config) {
     
     int opt;
     int player_mode = 0;
+    int size_given = 0;
     
     // Definir opciones largas
     static struct option long_options[] = {
         {"help", no_argument, 0, 0},
+        {"pin-master", required_argument, 0, OPT_PIN_MASTER},
+        {"pin-view", required_argument, 0, OPT_PIN_VIEW},
+        {"pin-players", required_argument, 0, OPT_PIN_PLAYERS},
+        {"master-nice", required_argument, 0, OPT_MASTER_NICE},
+        {"prefault", no_argument, 0, OPT_PREFAULT},
+        {"hugepages", no_argument, 0, OPT_HUGEPAGES},
+        {"mlock", no_argument, 0, OPT_MLOCK},
+        {"spectate", required_argument, 0, OPT_SPECTATE},
         {0, 0, 0, 0}
     };
     
-    while ((opt = getopt_long(argc, argv, "w:h:d:t:s:v:p:", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "w:h:d:t:s:i:x:v:g:e:b:lk:T:r:o:D:B:mp:", long_options, NULL)) != -1) {
         switch (opt) {
             case 'w':
+                size_given = 1;
                 config->width = atoi(optarg);
                 if (config->width < MIN_WIDTH) {
                     fprintf(stderr, "Error: ancho mínimo es %d\n", MIN_WIDTH);
@@ -120,6 +334,7 @@ int parse_arguments(int argc, char *argv[], config_t *config) {
                 }
                 break;
             case 'h':
+                size_given = 1;
                 config->height = atoi(optarg);
                 if (config->height < MIN_HEIGHT) {
                     fprintf(stderr, "Error: alto mínimo es %d\n", MIN_HEIGHT);
@@ -143,9 +358,75 @@ int parse_arguments(int argc, char *argv[], config_t *config) {
             case 's':
                 config->seed = (unsigned int)atoi(optarg);
                 break;
+            case 'i':
+                config->board_import_path = optarg;
+                break;
+            case 'x':
+                config->board_export_path = optarg;
+                break;
             case 'v':
                 config->view_path = optarg;
                 break;
+            case 'g':
+                config->games = atoi(optarg);
+                if (config->games < 1) {
+                    fprintf(stderr, "Error: games debe ser >= 1\n");
+                    return -1;
+                }
+                break;
+            case 'e':
+                if (strcmp(optarg, "run") == 0) {
+                    config->early_end = EARLY_END_RUN;
+                } else if (strcmp(optarg, "bound") == 0) {
+                    config->early_end = EARLY_END_BOUND;
+                } else {
+                    fprintf(stderr, "Error: modo de resolución inválido '%s' (run | bound)\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'b':
+                config->bound_percent = atoi(optarg);
+                if (config->bound_percent < 0 || config->bound_percent > 100) {
+                    fprintf(stderr, "Error: percent debe estar entre 0 y 100\n");
+                    return -1;
+                }
+                break;
+            case 'l':
+                config->lockstep = 1;
+                break;
+            case 'k':
+                config->idle_rounds = atoi(optarg);
+                if (config->idle_rounds < 1) {
+                    fprintf(stderr, "Error: rounds debe ser >= 1\n");
+                    return -1;
+                }
+                break;
+            case 'T':
+                config->trace_path = optarg;
+                break;
+            case 'r':
+                config->ratings_path = optarg;
+                break;
+            case 'o':
+                config->metrics_path = optarg;
+                break;
+            case 'D':
+                config->move_deadline = atoi(optarg);
+                if (config->move_deadline < 0) {
+                    fprintf(stderr, "Error: el plazo debe ser >= 0\n");
+                    return -1;
+                }
+                break;
+            case 'B':
+                config->time_bank = atoi(optarg);
+                if (config->time_bank < 0) {
+                    fprintf(stderr, "Error: la reserva debe ser >= 0\n");
+                    return -1;
+                }
+                break;
+            case 'm':
+                config->use_mailbox = 1;
+                break;
             case 'p':
                 player_mode = 1;
                 // El primer jugador está en optarg
@@ -156,6 +437,33 @@ int parse_arguments(int argc, char *argv[], config_t *config) {
                     return -1;
                 }
                 break;
+            case OPT_PIN_MASTER:
+            case OPT_PIN_VIEW:
+            case OPT_PIN_PLAYERS: {
+                cpu_list_t *list = opt == OPT_PIN_MASTER ? &config->pin_master
+                                 : opt == OPT_PIN_VIEW ? &config->pin_view : &config->pin_players;
+                if (parseCpuList(optarg, list) != 0) {
+                    fprintf(stderr, "Error: lista de CPUs inválida '%s'\n", optarg);
+                    return -1;
+                }
+                break;
+            }
+            case OPT_MASTER_NICE:
+                config->master_nice = atoi(optarg);
+                config->set_master_nice = 1;
+                break;
+            case OPT_PREFAULT:
+                config->shm_options |= SHM_PREFAULT;
+                break;
+            case OPT_HUGEPAGES:
+                config->shm_options |= SHM_HUGEPAGES;
+                break;
+            case OPT_MLOCK:
+                config->shm_options |= SHM_MLOCK;
+                break;
+            case OPT_SPECTATE:
+                config->spectate_path = optarg;
+                break;
             case 0:
                 // Opción larga --help
                 show_help(argv[0]);
@@ -173,11 +481,22 @@ int parse_arguments(int argc, char *argv[], config_t *config) {
         }
     }
     
+    if (config->board_import_path != NULL && size_given) {
+        fprintf(stderr, "Error: -w y -h no se pueden usar con -i, el tamaño sale del archivo de tableros\n");
+        return -1;
+    }
+
     // Validar número mínimo de jugadores
     if (config->num_players < MIN_JUGADORES) {
         fprintf(stderr, "Error: se requiere al menos %d jugador\n", MIN_JUGADORES);
         return -1;
     }
+
+    for (int i = 0; i < config->num_players; i++) {
+        if (split_player_spec(config, i) != 0) {
+            return -1;
+        }
+    }
     
     return 0;
 }
@@ -202,88 +521,69 @@ char *textAfter(char separator, char *str) {
 }
 
 /**
- * @brief Mueve un jugador a una posición y la ocupa en el tablero
+ * @brief Prepara el estado para una partida nueva: tablero, posiciones y puntajes
  * 
- * @param state Estado actual del juego
- * @param playerId ID del jugador a mover
- * @param targetX Coordenada X de destino
- * @param targetY Coordenada Y de destino
- * @return 0 si el movimiento es inválido, el puntaje de la posición si es válido
+ * @param state Estado del juego
+ * @param config Configuración del juego
+ * @param game Número de partida dentro de la sesión
  */
-int movePlayer(game_state_t *state, int playerId, unsigned short targetX, unsigned short targetY) {
-    if (targetX >= state->width || targetY >= state->height) {
-        return 0;
-    }
-    int score = state->tablero[targetY * state->width + targetX];
-    if (score <= 0) {
-        return 0;
-    }
-    state->jugadores[playerId].x = targetX;
-    state->jugadores[playerId].y = targetY;
-    state->tablero[targetY * state->width + targetX] = -playerId;
-    return score;
-}
+void setup_game(game_state_t *state, const config_t *config, int game) {
+    unsigned int seed = config->seed + game;
+    __atomic_add_fetch(&state->game, 1, __ATOMIC_RELEASE);
+    state->width = config->width;
+    state->height = config->height;
+    state->num_jugadores = config->num_players;
+    state->terminado = 0;
 
-/**
- * @brief Verifica si es posible escapar de una posición
- * 
- * @param state Estado actual del juego
- * @param centerX Coordenada X central
- * @param centerY Coordenada Y central
- * @return 1 si es escapable, 0 si no
- */
-int isEscapable(game_state_t *state, unsigned short centerX, unsigned short centerY) {
-    for (int offY = -1; offY <= 1; offY++)
-    {
-        int y = centerY+offY;
-        if (y < 0 || y >= state->height) continue;
-        for (int offX = -1; offX <= 1; offX++)
-        {
-            int x = centerX+offX;
-            if (offX == 0 && offY == 0) continue;
-            if (x < 0 || x >= state->width) continue;
+    if (g_boards.header != NULL) {
+        // Tablero y posiciones importados, ya validados al abrir el archivo. La
+        // semilla elige el tablero igual que elige uno generado, así másters con
+        // semillas distintas recorren partes distintas del archivo
+        loadBoard(&g_boards, seed, state);
+    } else {
+        // Generar tablero inicial
+        generateBoard(state, seed);
+        initNeighborTables(state);
 
-            if (state->tablero[y*state->width+x] > 0) return 1;
-        }
+        // Establecer posiciones iniciales de jugadores
+        setStartingPositions(state, seed);
     }
-    return 0;
-}
+    for (int i = 0; i < config->num_players; i++) {
+        state->jugadores[i].puntaje = 0;
+        state->jugadores[i].stuck = 0;
+        state->jugadores[i].validRequests = 0;
+        state->jugadores[i].invalidRequests = 0;
+        g_metrics[i] = (player_metrics_t){0, 0, 0, -1};
+        g_clocks[i] = (player_clock_t){(long long)config->time_bank * 1000000LL, 0};
+    }
+    g_game_moves = 0;
+    initRanking(state);
+    __atomic_add_fetch(&state->game, 1, __ATOMIC_RELEASE);
 
-/**
- * @brief Verifica si un jugador está atascado
- * 
- * @param state Estado actual del juego
- * @param playerId ID del jugador a verificar
- * @return 1 si está atascado, 0 si no
- */
-int isStuck(game_state_t *state, int playerId) {
-    jugador_t player = state->jugadores[playerId];
-    return player.stuck || !isEscapable(state, player.x, player.y);
+    if (g_board_export_fd != -1 && appendBoard(g_board_export_fd, state) != 0) {
+        perror("exportar tablero");
+    }
 }
 
 /**
- * @brief Establece las posiciones iniciales de los jugadores en el tablero
+ * @brief Exporta las opciones de mapeo pedidas para que las hereden los hijos
  * 
- * Coloca a los jugadores en posiciones distribuidas circularmente alrededor del centro
- * del tablero, evitando que empiecen en la misma posición.
+ * Se combinan con las que ya traía CHOMP_SHM, así ambas formas de pedirlas
+ * suman.
  * 
- * @param state Estado actual del juego
+ * @param options Opciones pedidas por línea de comandos
  */
-void setStartingPositions(game_state_t *state) {
-    double angleStep = 2*M_PI/state->num_jugadores;
-    double angle = (rand() / (double) RAND_MAX) * 2*M_PI;
-
-    unsigned short centerX = state->width/2;
-    unsigned short centerY = state->height/2;
-    double radius = (state->width < state->height ? state->width : state->height)*0.375;
-
-    for (size_t i = 0; i < state->num_jugadores; i++)
-    {
-        unsigned short x = centerX + cos(angle)*radius;
-        unsigned short y = centerY + sin(angle)*radius;
-        movePlayer(state, i, x, y);
-        angle += angleStep;
+void export_shm_options(int options) {
+    options |= sessionShmOptions();
+    if (options == 0) {
+        return;
     }
+    char value[32];
+    snprintf(value, sizeof(value), "%s%s%s",
+             (options & SHM_PREFAULT) ? "prefault," : "",
+             (options & SHM_HUGEPAGES) ? "huge," : "",
+             (options & SHM_MLOCK) ? "lock," : "");
+    setenv(SHM_OPTIONS_ENV, value, 1);
 }
 
 /**
@@ -300,20 +600,24 @@ int initialize_shared_memory(game_state_t **state, game_sync_t **sync, const con
         return -1;
     }
     
+    char shm_name[SHM_NAME_LENGTH];
+    int options = sessionShmOptions();
+    size_t state_size = sessionShmSize(sizeof(game_state_t), options);
+
     // Crear memoria compartida para el estado del juego
-    int shm_state_fd = shm_open("/game_state", O_CREAT | O_RDWR, 0666);
+    int shm_state_fd = shm_open(sessionShmName("/game_state", shm_name), O_CREAT | O_RDWR, 0666);
     if (shm_state_fd == -1) {
         perror("shm_open game_state");
         return -1;
     }
     
-    if (ftruncate(shm_state_fd, sizeof(game_state_t)) == -1) {
+    if (ftruncate(shm_state_fd, state_size) == -1) {
         perror("ftruncate game_state");
         close(shm_state_fd);
         return -1;
     }
     
-    *state = mmap(NULL, sizeof(game_state_t), PROT_READ | PROT_WRITE, MAP_SHARED, shm_state_fd, 0);
+    *state = mapSessionSegment(shm_state_fd, state_size, PROT_READ | PROT_WRITE, options);
     if (*state == MAP_FAILED) {
         perror("mmap game_state");
         close(shm_state_fd);
@@ -321,33 +625,13 @@ int initialize_shared_memory(game_state_t **state, game_sync_t **sync, const con
     }
 
     // Inicializar estado del juego
-    (*state)->width = config->width;
-    (*state)->height = config->height;
-    (*state)->num_jugadores = config->num_players;
-    (*state)->terminado = 0;
-
-    // Generar tablero inicial
-    srand(config->seed);
-    for (int y = 0; y < (*state)->height; y++) {
-        for (int x = 0; x < (*state)->width; x++) {
-            (*state)->tablero[y * (*state)->width + x] = 1 + rand() % 9;
-        }
-    }
-    
-    // Establecer posiciones iniciales de jugadores
-    setStartingPositions(*state);
-    for (int i = 0; i < config->num_players; i++) {
-        (*state)->jugadores[i].puntaje = 0;
-        (*state)->jugadores[i].stuck = 0;
-        (*state)->jugadores[i].validRequests = 0;
-        (*state)->jugadores[i].invalidRequests = 0;
-    }
+    setup_game(*state, config, 0);
 
     // Crear memoria compartida para sincronización
-    int shm_sync_fd = shm_open("/game_sync", O_CREAT | O_RDWR, 0666);
+    int shm_sync_fd = shm_open(sessionShmName("/game_sync", shm_name), O_CREAT | O_RDWR, 0666);
     if (shm_sync_fd == -1) {
         perror("shm_open game_sync");
-        munmap(*state, sizeof(game_state_t));
+        munmap(*state, state_size);
         close(shm_state_fd);
         return -1;
     }
@@ -355,23 +639,60 @@ int initialize_shared_memory(game_state_t **state, game_sync_t **sync, const con
     if (ftruncate(shm_sync_fd, sizeof(game_sync_t)) == -1) {
         perror("ftruncate game_sync");
         close(shm_sync_fd);
-        munmap(*state, sizeof(game_state_t));
+        munmap(*state, state_size);
         close(shm_state_fd);
         return -1;
     }
     
-    *sync = mmap(NULL, sizeof(game_sync_t), PROT_READ | PROT_WRITE, MAP_SHARED, shm_sync_fd, 0);
+    // El segmento de sincronización es chico: no tiene sentido una página grande
+    *sync = mapSessionSegment(shm_sync_fd, sizeof(game_sync_t), PROT_READ | PROT_WRITE, options & ~SHM_HUGEPAGES);
     if (*sync == MAP_FAILED) {
         perror("mmap game_sync");
         close(shm_sync_fd);
-        munmap(*state, sizeof(game_state_t));
+        munmap(*state, state_size);
         close(shm_state_fd);
         return -1;
     }
 
+    // Inicializar buzones de movimientos
+    (*sync)->transport = config->use_mailbox ? TRANSPORT_MAILBOX : TRANSPORT_PIPE;
+    (*sync)->more_games = config->games > 1;
+    memset(&(*sync)->master_doorbell, 0, sizeof((*sync)->master_doorbell));
+    memset((*sync)->mailboxes, 0, sizeof((*sync)->mailboxes));
+
     return 0;
 }
 
+/**
+ * @brief Crea el segmento de estadísticas que leen herramientas como chompstat
+ * 
+ * Si no se puede crear, el máster sigue funcionando con contadores locales.
+ */
+void initialize_stats_segment() {
+    char shm_name[SHM_NAME_LENGTH];
+    int fd = shm_open(sessionShmName(STATS_SHM_NAME, shm_name), O_CREAT | O_RDWR, 0666);
+    if (fd == -1) {
+        perror("shm_open game_stats");
+        return;
+    }
+    if (ftruncate(fd, sizeof(master_stats_t)) == -1) {
+        perror("ftruncate game_stats");
+        close(fd);
+        return;
+    }
+    master_stats_t *stats = mmap(NULL, sizeof(master_stats_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (stats == MAP_FAILED) {
+        perror("mmap game_stats");
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->master_pid = getpid();
+    stats->running = 1;
+    g_stats = stats;
+}
+
 /**
  * @brief Inicializa todos los semáforos necesarios para la sincronización
  * 
@@ -442,9 +763,10 @@ int initialize_semaphores(game_sync_t *sync, int num_players) {
  * 
  * @param vista Puntero al PID del proceso de vista
  * @param view_path Ruta del binario de la vista
+ * @param pin CPUs a las que fijar la vista (lista vacía = sin fijar)
  * @return 0 en éxito, -1 en error
  */
-int launch_view_process(pid_t *vista, const char *view_path) {
+int launch_view_process(pid_t *vista, const char *view_path, const cpu_list_t *pin) {
     if (!vista || !view_path) {
         fprintf(stderr, "Error: Parámetros inválidos para launch_view_process\n");
         return -1;
@@ -453,6 +775,7 @@ int launch_view_process(pid_t *vista, const char *view_path) {
     *vista = fork();
     if (*vista == 0) {
         // Proceso hijo = vista
+        if (pinToCpuList(pin) != 0) perror("sched_setaffinity vista");
         execl(view_path, "vista", NULL);
         perror("execl vista");
         exit(1);
@@ -487,6 +810,10 @@ int launch_player_processes(pid_t *jugadores, int pipes[MAX_JUGADORES][2], const
         pid_t pid = fork();
         if (pid == 0) {
             // Proceso hijo = jugador
+
+            // Publicar el PID antes del exec para que getPlayer() lo encuentre
+            // aunque el jugador arranque antes de que el padre lo registre
+            state->jugadores[i].pid = getpid();
             
             // CRÍTICO: Cerrar TODOS los pipes heredados de otros jugadores
             for (int j = 0; j < i; j++) {
@@ -503,10 +830,15 @@ int launch_player_processes(pid_t *jugadores, int pipes[MAX_JUGADORES][2], const
             close(pipes[i][1]);
 
             // Usar la ruta del jugador especificada en la configuración
+            if (pinToCpuSlot(&config->pin_players, i) != 0) perror("sched_setaffinity jugador");
+
             char player_name[64];
             snprintf(player_name, sizeof(player_name), "jugador%d", i);
-            execl(config->player_paths[i], player_name, NULL);
-            perror("execl jugador");
+            char *player_argv[MAX_PLAYER_ARGS + 2];
+            memcpy(player_argv, config->player_args[i], sizeof(player_argv));
+            player_argv[0] = player_name;
+            execv(config->player_paths[i], player_argv);
+            perror("execv jugador");
             exit(1); // solo llega si execl falla
         } else if (pid > 0) {
             jugadores[i] = pid;
@@ -522,34 +854,207 @@ int launch_player_processes(pid_t *jugadores, int pipes[MAX_JUGADORES][2], const
 }
 
 /**
- * @brief Procesa los movimientos de los jugadores en una iteración
+ * @brief Retorna el tiempo monótono actual en nanosegundos
+ * 
+ * @return Nanosegundos desde un origen arbitrario fijo
+ */
+unsigned long long monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * @brief Toma el lock de escritura del estado, registrando el tiempo de espera
+ * 
+ * @param sync Estructura de sincronización
+ */
+void lock_state_for_write(game_sync_t *sync) {
+    unsigned long long start = monotonic_ns();
+    sem_wait(&sync->master_access_mutex);
+    sem_wait(&sync->game_state_mutex);
+    sem_post(&sync->master_access_mutex);
+    statAdd(&g_stats->lock_wait_ns, monotonic_ns() - start);
+    traceSpan("lock", start);
+}
+
+/**
+ * @brief Libera el lock de escritura del estado
+ * 
+ * @param sync Estructura de sincronización
+ */
+void unlock_state(game_sync_t *sync) {
+    sem_post(&sync->game_state_mutex);
+}
+
+/**
+ * @brief Avisa a la vista que hay cambios y espera a que termine de imprimir
+ * 
+ * @param sync Estructura de sincronización
+ */
+void notify_view(game_sync_t *sync) {
+    unsigned long long start = monotonic_ns();
+    sem_post(&sync->view_update_signal);
+    sem_wait(&sync->view_done_signal);
+    statAdd(&g_stats->view_wait_ns, monotonic_ns() - start);
+    traceSpan("view", start);
+}
+
+/**
+ * @brief Entrega a un jugador la ficha que le permite enviar un movimiento
+ * 
+ * @param sync Estructura de sincronización
+ * @param playerId ID del jugador
+ */
+void post_move_token(game_sync_t *sync, int playerId) {
+    g_metrics[playerId].token_ns = monotonic_ns();
+    if (sync->transport == TRANSPORT_MAILBOX) {
+        futexSemPost(&sync->mailboxes[playerId].turn);
+    } else {
+        sem_post(&(sync->player_move_token[playerId]));
+    }
+}
+
+/**
+ * @brief Cierra la espera de un movimiento recibido y acumula su demora
+ * 
+ * @param playerId ID del jugador
+ * @return Nanosegundos desde que se entregó la ficha, 0 si no había ficha registrada
+ */
+unsigned long long end_move_wait(int playerId) {
+    player_metrics_t *metrics = &g_metrics[playerId];
+    if (metrics->token_ns == 0) return 0;
+
+    unsigned long long waited = monotonic_ns() - metrics->token_ns;
+    metrics->latency_ns += waited;
+    metrics->latency_samples++;
+    metrics->token_ns = 0;
+    return waited;
+}
+
+/**
+ * @brief Cuenta una jugada perdida por tiempo como movimiento inválido
+ * 
+ * @param state Estado del juego
+ * @param sync Estructura de sincronización
+ * @param playerId ID del jugador
+ */
+void forfeit_move(game_state_t *state, game_sync_t *sync, int playerId) {
+    lock_state_for_write(sync);
+    state->jugadores[playerId].invalidRequests++;
+    updateRanking(state, playerId);
+    unlock_state(sync);
+    statAdd(&g_stats->invalid_moves, 1);
+    statAdd(&g_stats->moves, 1);
+    spectateUpdate(&g_spectators, state, playerId, 0);
+}
+
+/**
+ * @brief Descuenta del reloj del jugador lo que tardó en mover
+ * 
+ * Los primeros move_deadline ms de cada movimiento son libres; el exceso se
+ * paga con la reserva. Si no alcanza, la jugada se pierde y la reserva queda
+ * en cero.
+ * 
+ * @param playerId ID del jugador
+ * @param waited Nanosegundos desde que se entregó la ficha
+ * @param config Configuración del juego
+ * @return 1 si el movimiento se aplica, 0 si se pierde por tiempo, -1 si ya se había penalizado al vencer
+ */
+int charge_clock(int playerId, unsigned long long waited, const config_t *config) {
+    player_clock_t *clock = &g_clocks[playerId];
+    if (config->move_deadline == 0) return 1;
+    if (clock->overdue) {
+        // Ya se contó como inválido cuando venció; llega tarde y se descarta
+        clock->overdue = 0;
+        return -1;
+    }
+
+    long long excess = (long long)waited - (long long)config->move_deadline * 1000000LL;
+    if (excess <= 0) return 1;
+    clock->bank_ns -= excess;
+    if (clock->bank_ns < 0) {
+        clock->bank_ns = 0;
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Penaliza a los jugadores cuya ficha venció sin respuesta
+ * 
+ * Un jugador colgado no puede frenar a los demás ni evitar la penalización:
+ * al vencer plazo + reserva se le cuenta la jugada como inválida, aunque su
+ * movimiento llegue más tarde (y entonces se descarta).
  * 
  * @param state Estado del juego
  * @param sync Estructura de sincronización
+ * @param pending Jugadores con una ficha entregada cuyo movimiento no llegó
+ * @param config Configuración del juego
+ */
+void expire_move_deadlines(game_state_t *state, game_sync_t *sync, const int pending[], const config_t *config) {
+    if (config->move_deadline == 0) return;
+    unsigned long long now = monotonic_ns();
+
+    for (int i = 0; i < config->num_players; i++) {
+        player_clock_t *clock = &g_clocks[i];
+        unsigned long long token_ns = g_metrics[i].token_ns;
+        if (!pending[i] || clock->overdue || token_ns == 0) continue;
+
+        long long limit = (long long)config->move_deadline * 1000000LL + clock->bank_ns;
+        if ((long long)(now - token_ns) > limit) {
+            clock->overdue = 1;
+            clock->bank_ns = 0;
+            forfeit_move(state, sync, i);
+        }
+    }
+}
+
+/**
+ * @brief Milisegundos hasta que venza la primera ficha pendiente, contando la reserva
+ * 
+ * @param pending Jugadores con una ficha entregada cuyo movimiento no llegó
+ * @param config Configuración del juego
+ * @return Milisegundos (0 si ya venció alguna), -1 si no hay plazos pendientes
+ */
+int next_deadline_ms(const int pending[], const config_t *config) {
+    if (config->move_deadline == 0) return -1;
+    unsigned long long now = monotonic_ns();
+    long long earliest = -1;
+
+    for (int i = 0; i < config->num_players; i++) {
+        const player_clock_t *clock = &g_clocks[i];
+        unsigned long long token_ns = g_metrics[i].token_ns;
+        if (!pending[i] || clock->overdue || token_ns == 0) continue;
+
+        long long limit = (long long)config->move_deadline * 1000000LL + clock->bank_ns;
+        long long left = limit - (long long)(now - token_ns);
+        if (earliest < 0 || left < earliest) earliest = left > 0 ? left : 0;
+    }
+    // Redondeo hacia arriba para despertar con el plazo ya vencido
+    return earliest < 0 ? -1 : (int)((earliest + 999999) / 1000000);
+}
+
+/**
+ * @brief Recolecta los movimientos pendientes en los pipes de los jugadores
+ * 
  * @param pipes Pipes de comunicación con jugadores
  * @param active_players Array de jugadores activos (puede ser NULL)
  * @param config Configuración del juego
- * @param last_movement_time Tiempo del último movimiento
+ * @param moves Movimiento recibido de cada jugador, -1 si no envió ninguno
  * @return 0 en éxito, -1 en error
  */
-int process_player_moves(game_state_t *state, game_sync_t *sync, int pipes[MAX_JUGADORES][2], 
-                        int active_players[], const config_t *config, time_t *last_movement_time) {
-    if (!state || !sync || !pipes || !config || !last_movement_time) {
-        fprintf(stderr, "Error: Parámetros inválidos para process_player_moves\n");
-        return -1;
-    }
-    
+int collect_pipe_moves(int pipes[MAX_JUGADORES][2], int active_players[], const config_t *config, int moves[]) {
     // Configurar select para leer de todos los jugadores
     fd_set readfds;
     int max_fd = -1;
     
     FD_ZERO(&readfds);
-    int active_count = 0;
     for (int i = 0; i < config->num_players; i++) {
+        moves[i] = -1;
         if (active_players == NULL || active_players[i]) {
             FD_SET(pipes[i][0], &readfds);
             if (pipes[i][0] > max_fd) max_fd = pipes[i][0];
-            active_count++;
         }
     }
     
@@ -560,7 +1065,6 @@ int process_player_moves(game_state_t *state, game_sync_t *sync, int pipes[MAX_J
         return -1;
     }
     
-    // Procesar movimientos de jugadores listos
     for (int i = 0; i < config->num_players; i++) {
         if ((active_players != NULL && !active_players[i]) || !FD_ISSET(pipes[i][0], &readfds)) {
             continue;
@@ -576,65 +1080,234 @@ int process_player_moves(game_state_t *state, game_sync_t *sync, int pipes[MAX_J
             }
             continue;
         }
+        moves[i] = move;
+    }
+    return 0;
+}
 
-        // Sincronización para acceso al estado
-        sem_wait(&sync->master_access_mutex);
-        sem_wait(&sync->game_state_mutex);
-        sem_post(&sync->master_access_mutex);
-        
-        unsigned short x = state->jugadores[i].x;
-        unsigned short y = state->jugadores[i].y;
-        unsigned short nx = x, ny = y;
-
-        // Interpretar movimiento
-        switch (move) {
-            case 0: ny--; break;                    // arriba
-            case 1: { ny--; nx++; } break;          // arriba-derecha
-            case 2: nx++; break;                    // derecha
-            case 3: { ny++; nx++; } break;          // abajo-derecha
-            case 4: ny++; break;                    // abajo
-            case 5: { ny++; nx--; } break;          // abajo-izquierda
-            case 6: nx--; break;                    // izquierda
-            case 7: { ny--; nx--; } break;          // arriba-izquierda
-            default: break;                         // movimiento inválido
-        }
-
-        // Verificar y ejecutar movimiento
-        int moveResult = movePlayer(state, i, nx, ny);
-        
-        if (moveResult > 0) {
-            state->jugadores[i].validRequests++;
-            state->jugadores[i].puntaje += moveResult;
-            *last_movement_time = time(NULL);
-        } else {
-            state->jugadores[i].invalidRequests++;
-        }
+/**
+ * @brief Indica si un jugador terminó, mirando si su pipe llegó a fin de archivo
+ * 
+ * Con buzones el jugador no manda movimientos por el pipe, pero el máster
+ * conserva el extremo de lectura: cuando el jugador termina queda en EOF. Lo
+ * que el jugador haya escrito en su stdout se descarta.
+ * 
+ * @param pipes Pipes de comunicación con jugadores
+ * @param playerId ID del jugador
+ * @return 1 si el jugador terminó, 0 si no
+ */
+int player_exited(int pipes[MAX_JUGADORES][2], int playerId) {
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    FD_SET(pipes[playerId][0], &readfds);
+    struct timeval timeout = {0, 0};
+    if (select(pipes[playerId][0] + 1, &readfds, NULL, NULL, &timeout) <= 0) {
+        return 0;
+    }
+    char discard[64];
+    return read(pipes[playerId][0], discard, sizeof(discard)) == 0;
+}
 
-        // Verificar si el jugador está atascado
-        if (isStuck(state, i)) {
-            state->jugadores[i].stuck = 1;
-            if (active_players != NULL) {
+/**
+ * @brief Recolecta los movimientos pendientes en los buzones de los jugadores
+ * 
+ * Si ningún jugador publicó un movimiento, bloquea en el futex del máster
+ * hasta que alguno lo haga o venza el timeout global. La espera se corta
+ * cada EXIT_POLL_MS para notar a los jugadores que terminaron, que con
+ * buzones no tocan el futex; como en collect_pipe_moves, quedan inactivos.
+ * También vuelve al vencer la primera ficha pendiente, para que
+ * expire_move_deadlines penalice a tiempo aunque nadie más mueva.
+ * 
+ * @param sync Estructura de sincronización
+ * @param pipes Pipes de comunicación con jugadores
+ * @param active_players Array de jugadores activos (puede ser NULL)
+ * @param pending Jugadores con una ficha entregada cuyo movimiento no llegó
+ * @param config Configuración del juego
+ * @param last_movement_time Tiempo del último movimiento
+ * @param moves Movimiento recibido de cada jugador, -1 si no envió ninguno
+ * @return 0 en éxito
+ */
+int collect_mailbox_moves(game_sync_t *sync, int pipes[MAX_JUGADORES][2], int active_players[],
+                          const int pending[], const config_t *config, time_t last_movement_time, int moves[]) {
+    for (;;) {
+        int found = 0;
+        for (int i = 0; i < config->num_players; i++) {
+            unsigned char move;
+            moves[i] = -1;
+            if (active_players != NULL && !active_players[i]) continue;
+            if (mailboxConsume(&sync->mailboxes[i], &move)) {
+                moves[i] = move;
+                found++;
+            } else if (active_players != NULL && player_exited(pipes, i)) {
+                printf("[Master] Jugador %d terminó o se desconectó\n", i);
                 active_players[i] = 0;
+                found++;
             }
-        } else {
-            sem_post(&(sync->player_move_token[i]));
         }
+        if (found > 0) break;
 
-        sem_post(&sync->game_state_mutex);
-    }
-
-    // Verificar si el juego debe terminar
-    if (active_players != NULL) {
-        int remaining_players = 0;
-        for (int i = 0; i < config->num_players; i++) {
-            if (active_players[i]) remaining_players++;
-        }
-        if (remaining_players == 0) {
-            state->terminado = 1;
+        int wait_ms = EXIT_POLL_MS;
+        if (config->timeout > 0) {
+            int left_ms = (int)(last_movement_time + config->timeout - time(NULL)) * 1000;
+            if (left_ms <= 0) break;
+            if (left_ms < wait_ms) wait_ms = left_ms;
         }
+        int deadline_ms = next_deadline_ms(pending, config);
+        if (deadline_ms == 0) break;
+        if (deadline_ms > 0 && deadline_ms < wait_ms) wait_ms = deadline_ms;
+        futexSemWait(&sync->master_doorbell, wait_ms);
     }
-    
-    // Verificar timeout global
+    return 0;
+}
+
+/**
+ * @brief Aplica un movimiento de un jugador sobre el estado del juego
+ * 
+ * Toma el lock de escritura, mueve al jugador, actualiza sus contadores y lo
+ * marca como atascado si ya no tiene casilleros libres alrededor.
+ * 
+ * @param state Estado del juego
+ * @param sync Estructura de sincronización
+ * @param playerId ID del jugador
+ * @param move Movimiento recibido (0-7, otro valor es inválido)
+ * @return 0 si el movimiento es inválido, el puntaje obtenido si es válido
+ */
+int apply_player_move(game_state_t *state, game_sync_t *sync, int playerId, unsigned char move) {
+    player_metrics_t *metrics = &g_metrics[playerId];
+    g_game_moves++;
+
+    // Sincronización para acceso al estado
+    lock_state_for_write(sync);
+    
+    unsigned short x = state->jugadores[playerId].x;
+    unsigned short y = state->jugadores[playerId].y;
+    unsigned short nx = x, ny = y;
+
+    // Interpretar movimiento
+    switch (move) {
+        case 0: ny--; break;                    // arriba
+        case 1: { ny--; nx++; } break;          // arriba-derecha
+        case 2: nx++; break;                    // derecha
+        case 3: { ny++; nx++; } break;          // abajo-derecha
+        case 4: ny++; break;                    // abajo
+        case 5: { ny++; nx--; } break;          // abajo-izquierda
+        case 6: nx--; break;                    // izquierda
+        case 7: { ny--; nx--; } break;          // arriba-izquierda
+        default: break;                         // movimiento inválido
+    }
+
+    // Verificar y ejecutar movimiento
+    unsigned long long trace_start = traceNow();
+    int moveResult = movePlayer(state, playerId, nx, ny);
+    
+    if (moveResult > 0) {
+        state->jugadores[playerId].validRequests++;
+        state->jugadores[playerId].puntaje += moveResult;
+        statAdd(&g_stats->valid_moves, 1);
+    } else {
+        state->jugadores[playerId].invalidRequests++;
+        statAdd(&g_stats->invalid_moves, 1);
+    }
+    updateRanking(state, playerId);
+    statAdd(&g_stats->moves, 1);
+
+    // Verificar si el jugador está atascado
+    if (isStuck(state, playerId)) {
+        state->jugadores[playerId].stuck = 1;
+        metrics->stuck_tick = g_game_moves;
+    }
+    traceSpan("movePlayer", trace_start);
+
+    unlock_state(sync);
+    spectateUpdate(&g_spectators, state, playerId, moveResult > 0);
+    return moveResult;
+}
+
+/**
+ * @brief Procesa los movimientos de los jugadores en una iteración
+ * 
+ * @param state Estado del juego
+ * @param sync Estructura de sincronización
+ * @param pipes Pipes de comunicación con jugadores
+ * @param active_players Array de jugadores activos (puede ser NULL)
+ * @param pending Jugadores con una ficha entregada cuyo movimiento no llegó
+ * @param config Configuración del juego
+ * @param last_movement_time Tiempo del último movimiento
+ * @return 0 en éxito, -1 en error
+ */
+int process_player_moves(game_state_t *state, game_sync_t *sync, int pipes[MAX_JUGADORES][2], 
+                        int active_players[], int pending[], const config_t *config, time_t *last_movement_time) {
+    if (!state || !sync || !pipes || !pending || !config || !last_movement_time) {
+        fprintf(stderr, "Error: Parámetros inválidos para process_player_moves\n");
+        return -1;
+    }
+    
+    int moves[MAX_JUGADORES];
+    unsigned long long trace_start = traceNow();
+    int collected = sync->transport == TRANSPORT_MAILBOX
+        ? collect_mailbox_moves(sync, pipes, active_players, pending, config, *last_movement_time, moves)
+        : collect_pipe_moves(pipes, active_players, config, moves);
+    if (collected != 0) {
+        return -1;
+    }
+    traceSpan("poll", trace_start);
+    statAdd(&g_stats->polls, 1);
+    for (int i = 0; i < config->num_players; i++) {
+        if (moves[i] >= 0) {
+            statAdd(&g_stats->wakeups, 1);
+            break;
+        }
+    }
+    
+    // Procesar movimientos de jugadores listos
+    for (int i = 0; i < config->num_players; i++) {
+        if (moves[i] < 0) {
+            continue;
+        }
+        unsigned char move = moves[i];
+        pending[i] = 0;
+
+        int charged = charge_clock(i, end_move_wait(i), config);
+        if (charged <= 0) {
+            // Jugada perdida por tiempo: el jugador vuelve a recibir la ficha
+            if (charged == 0) {
+                forfeit_move(state, sync, i);
+            }
+            post_move_token(sync, i);
+            pending[i] = 1;
+            continue;
+        }
+
+        int moveResult = apply_player_move(state, sync, i, move);
+        if (moveResult > 0) {
+            *last_movement_time = time(NULL);
+        }
+
+        if (state->jugadores[i].stuck) {
+            if (active_players != NULL) {
+                active_players[i] = 0;
+            }
+        } else {
+            post_move_token(sync, i);
+            pending[i] = 1;
+        }
+    }
+
+    expire_move_deadlines(state, sync, pending, config);
+
+    // Verificar si el juego debe terminar
+    if (active_players != NULL) {
+        int remaining_players = 0;
+        for (int i = 0; i < config->num_players; i++) {
+            if (active_players[i]) remaining_players++;
+        }
+        g_stats->players_active = remaining_players;
+        if (remaining_players == 0) {
+            state->terminado = 1;
+        }
+    }
+    
+    // Verificar timeout global
     time_t current_time = time(NULL);
     if (config->timeout > 0 && (current_time - *last_movement_time) >= config->timeout) {
         state->terminado = 1;
@@ -643,20 +1316,441 @@ int process_player_moves(game_state_t *state, game_sync_t *sync, int pipes[MAX_J
     return 0;
 }
 
+/**
+ * @brief Termina y recolecta a los jugadores guardando su consumo de recursos
+ * 
+ * Deja en 0 los PIDs recolectados para que cleanup_resources no los espere
+ * de nuevo.
+ * 
+ * @param jugadores Array de PIDs de jugadores
+ * @param num_players Número de jugadores
+ */
+void reap_players(pid_t *jugadores, int num_players) {
+    for (int i = 0; i < num_players; i++) {
+        if (jugadores[i] > 0) {
+            kill(jugadores[i], SIGTERM);
+            if (wait4(jugadores[i], NULL, 0, &g_usage[i].usage) == jugadores[i]) {
+                g_usage[i].reaped = 1;
+            }
+            jugadores[i] = 0;
+        }
+    }
+}
+
+static double timeval_ms(struct timeval tv) {
+    return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+/**
+ * @brief Imprime el consumo de CPU y memoria de cada jugador en la sesión
+ * 
+ * Los jugadores salen en el orden del ranking de la última partida. El CPU
+ * por movimiento usa los movimientos válidos de todas las partidas.
+ * 
+ * @param state Estado de la última partida
+ */
+void print_resource_usage(game_state_t *state) {
+    printf("      === Resources ===\n");
+    printf("|------------------|---------|---------|----------|----------|---------------|---------------|\n");
+    printf("| name             | user ms |  sys ms | ms/valid | maxrss K |  ctxsw vol/inv| faults min/maj|\n");
+    printf("|------------------|---------|---------|----------|----------|---------------|---------------|\n");
+    for (size_t i = 0; i < state->num_jugadores; i++) {
+        int id = state->ranking[i];
+        const player_usage_t *entry = &g_usage[id];
+        if (!entry->reaped) {
+            printf("| %-16s | %7s | %7s | %8s | %8s | %13s | %13s |\n",
+                   state->jugadores[id].nombre, "-", "-", "-", "-", "-", "-");
+            continue;
+        }
+        const struct rusage *ru = &entry->usage;
+        double user_ms = timeval_ms(ru->ru_utime);
+        double sys_ms = timeval_ms(ru->ru_stime);
+        double per_move = entry->valid_moves ? (user_ms + sys_ms) / entry->valid_moves : 0.0;
+        printf("| %-16s | %7.0f | %7.0f | %8.3f | %8ld | %6ld/%-6ld | %6ld/%-6ld |\n",
+               state->jugadores[id].nombre, user_ms, sys_ms, per_move, ru->ru_maxrss,
+               ru->ru_nvcsw, ru->ru_nivcsw, ru->ru_minflt, ru->ru_majflt);
+    }
+    printf("|------------------|---------|---------|----------|----------|---------------|---------------|\n");
+}
+
 void printScores(game_state_t *state) {
     jugador_t *players = state->jugadores;
-    int *idOrder = getPlayerOrder(state);
-    if (!idOrder) return;
 
     printf("      === Results ===\n");
     printf("|------------------|------|\n");
     for (size_t i = 0; i < state->num_jugadores; i++) {
-        int id = idOrder[i];
+        int id = state->ranking[i];
         printf("| %-16s | %4u |\n", players[id].nombre, players[id].puntaje);
         printf("|------------------|------|\n");
     }
+}
+
+/**
+ * @brief Abre el archivo de métricas para agregar filas
+ * 
+ * @param path Ruta del archivo CSV
+ * @return Descriptor abierto en modo append, -1 en error
+ */
+int open_metrics(const char *path) {
+    return open(path, O_WRONLY | O_APPEND | O_CREAT, 0644);
+}
+
+/**
+ * @brief Agrega al CSV de métricas una fila por jugador de la partida terminada
+ * 
+ * Todas las filas de la partida salen en un único write con O_APPEND, así
+ * que varios másters pueden compartir el archivo sin intercalar filas. El
+ * lock solo protege la escritura del encabezado cuando el archivo está vacío.
+ * La columna seed queda vacía con tableros importados y board, el índice en
+ * el archivo de tableros, queda vacía con tableros generados.
+ * 
+ * @param fd Descriptor devuelto por open_metrics
+ * @param state Estado de la partida terminada
+ * @param config Configuración del juego
+ * @param game Índice de la partida en la sesión
+ */
+void write_game_metrics(int fd, game_state_t *state, const config_t *config, int game) {
+    static const char header[] = "run,game,seed,board,width,height,players,player,name,rank,score,"
+                                 "valid,invalid,stuck_tick,final_x,final_y,latency_us\n";
+    char rows[MAX_JUGADORES * 160];
+    size_t used = 0;
+
+    // Un tablero importado no sale de la semilla: se identifica por su índice en el archivo
+    char origin[32];
+    if (g_boards.header != NULL) {
+        snprintf(origin, sizeof(origin), ",%u", (config->seed + game) % g_boards.header->count);
+    } else {
+        snprintf(origin, sizeof(origin), "%u,", config->seed + game);
+    }
+
+    for (unsigned int r = 0; r < state->num_jugadores; r++) {
+        int id = state->ranking[r];
+        jugador_t *p = &state->jugadores[id];
+        player_metrics_t *m = &g_metrics[id];
+        double latency_us = m->latency_samples ? (double)m->latency_ns / m->latency_samples / 1000.0 : 0.0;
+        used += snprintf(rows + used, sizeof(rows) - used,
+                         "%d,%d,%s,%u,%u,%u,%d,%s,%u,%u,%u,%u,%d,%u,%u,%.1f\n",
+                         (int)getpid(), game, origin, state->width, state->height,
+                         state->num_jugadores, id, p->nombre, r + 1, p->puntaje,
+                         p->validRequests, p->invalidRequests, m->stuck_tick, p->x, p->y, latency_us);
+    }
+
+    flock(fd, LOCK_EX);
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size == 0) {
+        write(fd, header, sizeof(header) - 1);
+    }
+    if (write(fd, rows, used) != (ssize_t)used) {
+        perror("write metrics");
+    }
+    flock(fd, LOCK_UN);
+}
+
+/**
+ * @brief Espera y descarta los movimientos en curso al terminar una partida
+ * 
+ * Los jugadores que tenían una ficha responden sobre el tablero ya terminado.
+ * Hay que recibir esas respuestas antes de reiniciar el tablero para que no
+ * se apliquen en la partida siguiente. Un jugador que no responde dentro del
+ * timeout queda fuera del resto de la sesión.
+ * 
+ * @param sync Estructura de sincronización
+ * @param pipes Pipes de comunicación con jugadores
+ * @param connected Jugadores que siguen en la sesión
+ * @param pending Jugadores con una ficha entregada cuyo movimiento no llegó
+ * @param config Configuración del juego
+ */
+void drain_pending_moves(game_sync_t *sync, int pipes[MAX_JUGADORES][2], int connected[],
+                         int pending[], const config_t *config) {
+    int wait_s = config->timeout > 0 ? config->timeout : DEFAULT_TIMEOUT;
+    time_t deadline = time(NULL) + wait_s;
+
+    for (int i = 0; i < config->num_players; i++) {
+        if (!pending[i]) continue;
+        pending[i] = 0;
+
+        int received = 0;
+        if (sync->transport == TRANSPORT_MAILBOX) {
+            unsigned char move;
+            while (!(received = mailboxConsume(&sync->mailboxes[i], &move))) {
+                int wait_ms = (int)(deadline - time(NULL)) * 1000;
+                if (wait_ms <= 0 || futexSemWait(&sync->master_doorbell, wait_ms) != 0) break;
+            }
+        } else {
+            fd_set readfds;
+            FD_ZERO(&readfds);
+            FD_SET(pipes[i][0], &readfds);
+            long remaining = deadline - time(NULL);
+            struct timeval timeout = {remaining > 0 ? remaining : 0, 0};
+            unsigned char move;
+            if (select(pipes[i][0] + 1, &readfds, NULL, NULL, &timeout) > 0) {
+                received = read(pipes[i][0], &move, sizeof(move)) > 0;
+            }
+        }
+
+        if (!received) {
+            printf("[Master] Jugador %d no respondió, queda fuera de la sesión\n", i);
+            connected[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Reinicia el estado compartido para la siguiente partida de la sesión
+ * 
+ * @param state Estado del juego
+ * @param sync Estructura de sincronización
+ * @param connected Jugadores que siguen en la sesión
+ * @param config Configuración del juego
+ * @param game Número de partida dentro de la sesión
+ */
+void start_next_game(game_state_t *state, game_sync_t *sync, const int connected[],
+                     const config_t *config, int game) {
+    lock_state_for_write(sync);
+
+    setup_game(state, config, game);
+    for (int i = 0; i < config->num_players; i++) {
+        if (!connected[i]) state->jugadores[i].stuck = 1;
+    }
+    sync->more_games = game + 1 < config->games;
+
+    unlock_state(sync);
+}
+
+/**
+ * @brief Aplica la resolución anticipada si ninguna región es disputada
+ * 
+ * @param state Estado del juego
+ * @param sync Estructura de sincronización
+ * @param active_players Array de jugadores activos
+ * @param config Configuración del juego
+ * @return 1 si el resultado quedó decidido, 0 si no
+ */
+int resolve_decided_regions(game_state_t *state, game_sync_t *sync, int active_players[], const config_t *config) {
+    unsigned int bounds[MAX_JUGADORES];
+
+    lock_state_for_write(sync);
+
+    int decided = regionsDecided(state, active_players, bounds);
+    if (decided && config->early_end == EARLY_END_BOUND) {
+        for (int i = 0; i < config->num_players; i++) {
+            if (!active_players[i]) continue;
+            state->jugadores[i].puntaje += (unsigned int)((unsigned long)bounds[i] * config->bound_percent / 100);
+            updateRanking(state, i);
+        }
+        state->terminado = 1;
+    }
 
-    free(idOrder);
+    unlock_state(sync);
+    if (decided && config->early_end == EARLY_END_BOUND) {
+        for (int i = 0; i < config->num_players; i++) {
+            if (active_players[i]) spectateUpdate(&g_spectators, state, i, 0);
+        }
+    }
+    return decided;
+}
+
+/**
+ * @brief Juega una partida completa sobre el estado ya preparado
+ * 
+ * @param state Estado del juego
+ * @param sync Estructura de sincronización
+ * @param pipes Pipes de comunicación con jugadores
+ * @param connected Jugadores que siguen en la sesión
+ * @param pending Jugadores con una ficha entregada cuyo movimiento no llegó
+ * @param config Configuración del juego
+ */
+void run_game(game_state_t *state, game_sync_t *sync, int pipes[MAX_JUGADORES][2],
+              int connected[], int pending[], const config_t *config) {
+    // Enviar estado inicial a la vista si existe
+    if (config->view_path != NULL) {
+        notify_view(sync);
+    }
+
+    // Inicializar jugadores como activos
+    int active_players[MAX_JUGADORES];
+    for (int i = 0; i < config->num_players; i++) {
+        active_players[i] = connected[i];
+        if (active_players[i]) {
+            post_move_token(sync, i);
+            pending[i] = 1;
+        }
+    }
+
+    if (config->delay > 0) {
+        usleep(config->delay * 1000);
+    }
+    
+    // Bucle principal del juego
+    time_t last_movement_time = time(NULL);
+    int decided = 0;
+    unsigned int last_valid_moves = 0;
+    while (!state->terminado) {
+        unsigned long long tick_start = monotonic_ns();
+        if (process_player_moves(state, sync, pipes, active_players, pending, config, &last_movement_time) != 0) {
+            break;
+        }
+
+        // Las regiones solo cambian cuando hubo movimientos válidos
+        unsigned int valid_moves = 0;
+        for (int i = 0; i < config->num_players; i++) {
+            valid_moves += state->jugadores[i].validRequests;
+        }
+        if (config->early_end != EARLY_END_NONE && !decided && !state->terminado
+                && valid_moves != last_valid_moves) {
+            last_valid_moves = valid_moves;
+            decided = resolve_decided_regions(state, sync, active_players, config);
+        }
+        
+        // Avisar a vista si existe; tras la resolución anticipada solo el final
+        if (config->view_path != NULL && (!decided || state->terminado)) {
+            notify_view(sync);
+        }
+        statAdd(&g_stats->ticks, 1);
+        statAdd(&g_stats->tick_ns, monotonic_ns() - tick_start);
+        
+        // Delay entre movimientos
+        if (config->delay > 0 && !decided) {
+            unsigned long long delay_start = traceNow();
+            usleep(config->delay * 1000);
+            traceSpan("delay", delay_start);
+        }
+    }
+
+    // Los jugadores inactivos que no quedaron atascados se desconectaron
+    for (int i = 0; i < config->num_players; i++) {
+        if (!active_players[i] && !state->jugadores[i].stuck) {
+            connected[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Bloquea hasta recibir el movimiento de un jugador
+ * 
+ * El timeout global solo sirve para detectar jugadores colgados; no influye
+ * en el resultado de una partida con jugadores sanos.
+ * 
+ * @param sync Estructura de sincronización
+ * @param pipes Pipes de comunicación con jugadores
+ * @param playerId ID del jugador
+ * @param config Configuración del juego
+ * @return El movimiento recibido, MOVE_DISCONNECTED si el jugador se desconectó
+ *         o MOVE_TIMED_OUT si no respondió dentro del timeout
+ */
+int wait_player_move(game_sync_t *sync, int pipes[MAX_JUGADORES][2], int playerId, const config_t *config) {
+    unsigned char move;
+    if (sync->transport == TRANSPORT_MAILBOX) {
+        int left_ms = config->timeout > 0 ? config->timeout * 1000 : -1;
+        while (!mailboxConsume(&sync->mailboxes[playerId], &move)) {
+            if (player_exited(pipes, playerId)) return MOVE_DISCONNECTED;
+            if (left_ms == 0) return MOVE_TIMED_OUT;
+            int wait_ms = left_ms < 0 || left_ms > EXIT_POLL_MS ? EXIT_POLL_MS : left_ms;
+            unsigned long long start = monotonic_ns();
+            futexSemWait(&sync->master_doorbell, wait_ms);
+            if (left_ms > 0) {
+                int waited_ms = (int)((monotonic_ns() - start) / 1000000ULL);
+                left_ms = waited_ms >= left_ms ? 0 : left_ms - waited_ms;
+            }
+        }
+        return move;
+    }
+
+    int ready;
+    do {
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(pipes[playerId][0], &readfds);
+        struct timeval timeout = {config->timeout, 0};
+        ready = select(pipes[playerId][0] + 1, &readfds, NULL, NULL, config->timeout > 0 ? &timeout : NULL);
+    } while (ready < 0 && errno == EINTR);
+    if (ready == 0) return MOVE_TIMED_OUT;
+    if (ready < 0 || read(pipes[playerId][0], &move, sizeof(move)) <= 0) {
+        return MOVE_DISCONNECTED;
+    }
+    return move;
+}
+
+/**
+ * @brief Juega una partida en modo lockstep
+ * 
+ * Los jugadores mueven de a uno en orden fijo: el máster entrega la ficha,
+ * bloquea hasta recibir el movimiento, lo aplica y sigue con el próximo.
+ * No hay pausas, sondeo ni sincronización con la vista durante la partida,
+ * y el timeout se mide en rondas, por lo que con jugadores deterministas el
+ * resultado depende solo de la semilla.
+ * 
+ * @param state Estado del juego
+ * @param sync Estructura de sincronización
+ * @param pipes Pipes de comunicación con jugadores
+ * @param connected Jugadores que siguen en la sesión
+ * @param config Configuración del juego
+ */
+void run_lockstep_game(game_state_t *state, game_sync_t *sync, int pipes[MAX_JUGADORES][2],
+                       int connected[], const config_t *config) {
+    int active_players[MAX_JUGADORES];
+    for (int i = 0; i < config->num_players; i++) {
+        active_players[i] = connected[i] && !state->jugadores[i].stuck;
+    }
+
+    int idle_rounds = 0;
+    while (!state->terminado) {
+        int remaining_players = 0;
+        int valid_moves = 0;
+
+        for (int i = 0; i < config->num_players; i++) {
+            if (!active_players[i]) continue;
+
+            unsigned long long tick_start = monotonic_ns();
+            post_move_token(sync, i);
+            unsigned long long trace_start = traceNow();
+            int move = wait_player_move(sync, pipes, i, config);
+            traceSpan("poll", trace_start);
+            statAdd(&g_stats->polls, 1);
+            if (move == MOVE_TIMED_OUT) {
+                // Un jugador colgado queda atascado y fuera de la sesión, como entre partidas
+                printf("[Master] Jugador %d no respondió, queda fuera de la sesión\n", i);
+                lock_state_for_write(sync);
+                state->jugadores[i].stuck = 1;
+                unlock_state(sync);
+                active_players[i] = 0;
+                connected[i] = 0;
+                continue;
+            }
+            if (move < 0) {
+                printf("[Master] Jugador %d terminó o se desconectó\n", i);
+                active_players[i] = 0;
+                connected[i] = 0;
+                continue;
+            }
+
+            statAdd(&g_stats->wakeups, 1);
+            end_move_wait(i);
+            if (apply_player_move(state, sync, i, move) > 0) {
+                valid_moves++;
+            }
+            statAdd(&g_stats->ticks, 1);
+            statAdd(&g_stats->tick_ns, monotonic_ns() - tick_start);
+            if (state->jugadores[i].stuck) {
+                active_players[i] = 0;
+            } else {
+                remaining_players++;
+            }
+        }
+
+        g_stats->players_active = remaining_players;
+        idle_rounds = valid_moves > 0 ? 0 : idle_rounds + 1;
+        if (remaining_players == 0 || idle_rounds >= config->idle_rounds) {
+            state->terminado = 1;
+        } else if (config->early_end == EARLY_END_BOUND && valid_moves > 0) {
+            resolve_decided_regions(state, sync, active_players, config);
+        }
+    }
+
+    // La vista solo recibe el estado final
+    if (config->view_path != NULL) {
+        notify_view(sync);
+    }
 }
 
 /**
@@ -704,15 +1798,26 @@ void cleanup_resources(game_state_t *state, game_sync_t *sync, pid_t *jugadores,
 
     // Desmapear memoria compartida
     if (state != NULL) {
-        munmap(state, sizeof(game_state_t));
+        munmap(state, sessionShmSize(sizeof(game_state_t), sessionShmOptions()));
     }
     if (sync != NULL) {
         munmap(sync, sizeof(game_sync_t));
     }
     
     // Desvincular memoria compartida
-    shm_unlink("/game_state");
-    shm_unlink("/game_sync");
+    char shm_name[SHM_NAME_LENGTH];
+    shm_unlink(sessionShmName("/game_state", shm_name));
+    shm_unlink(sessionShmName("/game_sync", shm_name));
+
+    // Cerrar el segmento de estadísticas
+    g_stats->running = 0;
+    if (g_stats != &local_stats) {
+        munmap(g_stats, sizeof(master_stats_t));
+        g_stats = &local_stats;
+        shm_unlink(sessionShmName(STATS_SHM_NAME, shm_name));
+    }
+
+    traceFinish();
 }
 
 /**
@@ -734,18 +1839,71 @@ int main(int argc, char *argv[]) {
         return parse_result == 1 ? 0 : 1; // 1 es para --help (salida exitosa)
     }
     
+    // Crear la traza antes de lanzar procesos para que la hereden por entorno
+    if (config.trace_path != NULL) {
+        if (traceCreate(config.trace_path) != 0) {
+            perror("trace");
+            return 1;
+        }
+        traceInit("master");
+    }
+
+    int metrics_fd = -1;
+    if (config.metrics_path != NULL && (metrics_fd = open_metrics(config.metrics_path)) == -1) {
+        perror(config.metrics_path);
+        return 1;
+    }
+
+    ratings_t ratings = {-1, NULL};
+    if (config.ratings_path != NULL && openRatings(&ratings, config.ratings_path, 1) != 0) {
+        perror(config.ratings_path);
+        return 1;
+    }
+
+    if (openSpectators(&g_spectators, config.spectate_path) != 0) {
+        perror(config.spectate_path);
+        return 1;
+    }
+
+    // Los tableros importados fijan el tamaño de todas las partidas de la sesión
+    if (config.board_import_path != NULL) {
+        if (openBoardFile(&g_boards, config.board_import_path, config.num_players) != 0) {
+            perror(config.board_import_path);
+            return 1;
+        }
+        config.width = g_boards.header->width;
+        config.height = g_boards.header->height;
+        if (config.width < MIN_WIDTH || config.height < MIN_HEIGHT) {
+            fprintf(stderr, "Error: %s tiene tableros de %dx%d, el mínimo es %dx%d\n",
+                    config.board_import_path, config.width, config.height, MIN_WIDTH, MIN_HEIGHT);
+            closeBoardFile(&g_boards);
+            return 1;
+        }
+    }
+    if (config.board_export_path != NULL
+        && (g_board_export_fd = open(config.board_export_path, O_RDWR | O_CREAT, 0644)) == -1) {
+        perror(config.board_export_path);
+        return 1;
+    }
+
     int pipes[MAX_JUGADORES][2];
     pid_t jugadores[MAX_JUGADORES];
     pid_t vista = -1;
     game_state_t *state = NULL;
     game_sync_t *sync = NULL;
 
+    // Las opciones de mapeo viajan por entorno hasta la vista y los jugadores
+    export_shm_options(config.shm_options);
+
     // Inicializar memoria compartida
     if (initialize_shared_memory(&state, &sync, &config) != 0) {
         fprintf(stderr, "Error: No se pudo inicializar la memoria compartida\n");
         return 1;
     }
 
+    // Publicar estadísticas para herramientas de monitoreo (no es fatal si falla)
+    initialize_stats_segment();
+
     // Inicializar semáforos
     if (initialize_semaphores(sync, config.num_players) != 0) {
         fprintf(stderr, "Error: No se pudieron inicializar los semáforos\n");
@@ -755,7 +1913,7 @@ int main(int argc, char *argv[]) {
 
     // Lanzar proceso de vista si se envió por argumentos
     if (config.view_path != NULL) {
-        if (launch_view_process(&vista, config.view_path) != 0) {
+        if (launch_view_process(&vista, config.view_path, &config.pin_view) != 0) {
             fprintf(stderr, "Error: No se pudo lanzar el proceso de vista\n");
             cleanup_resources(state, sync, jugadores, vista, pipes, config.num_players);
             return 1;
@@ -769,47 +1927,75 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    // Enviar estado inicial a la vista si existe
-    if (config.view_path != NULL) {
-        sem_post(&sync->view_update_signal);
-        sem_wait(&sync->view_done_signal);
+    // Ubicar al máster después de lanzar a los hijos para que no hereden su afinidad ni prioridad
+    if (pinToCpuList(&config.pin_master) != 0) {
+        perror("sched_setaffinity máster");
+    }
+    if (config.set_master_nice && setpriority(PRIO_PROCESS, 0, config.master_nice) != 0) {
+        perror("setpriority máster");
     }
 
-    // Inicializar jugadores como activos
-    int active_players[MAX_JUGADORES];
+    // Jugar las partidas de la sesión reutilizando los mismos procesos
+    int connected[MAX_JUGADORES];
+    int pending[MAX_JUGADORES];
     for (int i = 0; i < config.num_players; i++) {
-        sem_post(&(sync->player_move_token[i]));
-        active_players[i] = 1;
+        connected[i] = 1;
+        pending[i] = 0;
     }
 
-    if (config.delay > 0) {
-        usleep(config.delay * 1000);
-    }
-    
-    // Bucle principal del juego
-    time_t last_movement_time = time(NULL);
-    while (!state->terminado) {
-        if (process_player_moves(state, sync, pipes, active_players, &config, &last_movement_time) != 0) {
-            break;
+    for (int game = 0; game < config.games; game++) {
+        if (game > 0) {
+            drain_pending_moves(sync, pipes, connected, pending, &config);
+            start_next_game(state, sync, connected, &config, game);
         }
-        
-        // Avisar a vista si existe
-        if (config.view_path != NULL) {
-            sem_post(&sync->view_update_signal);
-            sem_wait(&sync->view_done_signal);
+        if (config.games > 1 && config.view_path == NULL) {
+            printf("[Master] Partida %d/%d (semilla %u)\n", game + 1, config.games, config.seed + game);
         }
-        
-        // Delay entre movimientos
-        if (config.delay > 0) {
-            usleep(config.delay * 1000);
+
+        spectateGame(&g_spectators, state, game);
+        if (config.lockstep) {
+            run_lockstep_game(state, sync, pipes, connected, &config);
+        } else {
+            run_game(state, sync, pipes, connected, pending, &config);
         }
-    }
 
-    // Si no hay vista, el master se encarga de imprimir los resultados
-    if (config.view_path == NULL) {
-        printScores(state);
+        g_stats->games_played++;
+        spectateEnd(&g_spectators, state);
+
+        // Si no hay vista, el master se encarga de imprimir los resultados
+        if (config.view_path == NULL) {
+            printScores(state);
+        }
+
+        if (ratings.store != NULL && recordGame(&ratings, state) != 0) {
+            perror("ratings");
+        }
+        if (metrics_fd != -1) {
+            write_game_metrics(metrics_fd, state, &config, game);
+        }
+        for (int i = 0; i < config.num_players; i++) {
+            g_usage[i].valid_moves += state->jugadores[i].validRequests;
+        }
+    }
+    closeRatings(&ratings);
+    if (config.spectate_path != NULL && config.view_path == NULL) {
+        printf("[Master] Espectadores: %llu resincronizaciones, %llu desconectados por error\n",
+               g_spectators.resyncs, g_spectators.dropped);
+    }
+    closeSpectators(&g_spectators);
+    closeBoardFile(&g_boards);
+    if (g_board_export_fd != -1) {
+        close(g_board_export_fd);
+    }
+    if (metrics_fd != -1) {
+        close(metrics_fd);
     }
     
+    reap_players(jugadores, config.num_players);
+    if (config.view_path == NULL) {
+        print_resource_usage(state);
+    }
+
     // Limpiar recursos
     cleanup_resources(state, sync, jugadores, vista, pipes, config.num_players);
     return 0;
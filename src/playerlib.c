@@ -1,13 +1,19 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
-#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE
 #include <playerlib.h>
+#include <game.h>
+#include <stdio.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 #include <math.h>
 #include <limits.h>
 #include <string.h>
+#include <trace.h>
+#include <pthread.h>
+#include <sched.h>
+#include <session.h>
 
 static char moveMap[3][3] = {
     {7,0,1},
@@ -15,12 +21,21 @@ static char moveMap[3][3] = {
     {5,4,3}
 };
 
+// Argumentos NOMBRE=valor recibidos del máster, para tuningParam
+static int tuningArgc = 0;
+static char **tuningArgv = NULL;
+
+// Inicio de la decisión actual, para el trazado
+static unsigned long long decisionStart = 0;
+
 game_state_t *getState() {
-    int fd = shm_open("/game_state", O_RDONLY, 0666);
+    char name[SHM_NAME_LENGTH];
+    int fd = shm_open(sessionShmName("/game_state", name), O_RDONLY, 0666);
     if (fd == -1) {
         return NULL;
     }
-    game_state_t *state = mmap(NULL, sizeof(game_state_t), PROT_READ, MAP_SHARED, fd, 0);
+    int options = sessionShmOptions();
+    game_state_t *state = mapSessionSegment(fd, sessionShmSize(sizeof(game_state_t), options), PROT_READ, options);
     close(fd); // Close file descriptor after mapping
     if (state == MAP_FAILED) {
         return NULL;
@@ -29,15 +44,17 @@ game_state_t *getState() {
 }
 
 game_sync_t *getSync() {
-    int fd = shm_open("/game_sync", O_RDWR, 0666);
+    char name[SHM_NAME_LENGTH];
+    int fd = shm_open(sessionShmName("/game_sync", name), O_RDWR, 0666);
     if (fd == -1) {
         return NULL;
     }
-    game_sync_t *sync = mmap(NULL, sizeof(game_sync_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    game_sync_t *sync = mapSessionSegment(fd, sizeof(game_sync_t), PROT_READ | PROT_WRITE, sessionShmOptions() & ~SHM_HUGEPAGES);
     close(fd); // Close file descriptor after mapping
     if (sync == MAP_FAILED) {
         return NULL;
     }
+    traceInit("jugador");
     return sync;
 }
 
@@ -53,24 +70,11 @@ jugador_t *getPlayer(game_state_t *state, pid_t playerPid, int *playerListIndex)
 }
 
 int freeNeighborCount(game_state_t *state, unsigned short x, unsigned short y) {
-    int count = 0;
-    for (int offY = -1; offY <= 1; offY++)
-    {
-        int ny = y + offY;
-        if (ny < 0 || ny >= state->height) continue;
-
-        for (int offX = -1; offX <= 1; offX++)
-        {
-            if (offX == 0 && offY == 0) continue;
-            int nx = x + offX;
-            if (nx < 0 || nx >= state->width) continue;
+    return state->free_neighbors[y * state->width + x];
+}
 
-            if (state->tablero[ny * state->width + nx] > 0) {
-                count++;
-            }
-        }
-    }
-    return count;
+unsigned char legalMoves(game_state_t *state, unsigned short x, unsigned short y) {
+    return state->legal_moves[y * state->width + x];
 }
 
 int squareDistanceToPlayer(game_state_t *state, int targetPlayerId, unsigned short fromX, unsigned short fromY) {
@@ -92,6 +96,90 @@ int sqrDistClosestOther(game_state_t *state, unsigned int callerId, unsigned sho
     return min;
 }
 
+void loadTuning(int argc, char *argv[]) {
+    tuningArgc = argc;
+    tuningArgv = argv;
+}
+
+double tuningParam(const char *name, double fallback) {
+    size_t length = strlen(name);
+    for (int i = 1; i < tuningArgc; i++) {
+        if (strncmp(tuningArgv[i], name, length) == 0 && tuningArgv[i][length] == '=') {
+            return strtod(tuningArgv[i] + length + 1, NULL);
+        }
+    }
+
+    char envName[128];
+    snprintf(envName, sizeof(envName), "CHOMP_%s", name);
+    const char *value = getenv(envName);
+    return value != NULL ? strtod(value, NULL) : fallback;
+}
+
+int stillPlaying(game_sync_t *sync, jugador_t *player) {
+    // En una sesión de varias partidas el jugador atascado espera la siguiente
+    return !player->stuck || sync->more_games;
+}
+
+void enterReader(game_sync_t *sync) {
+    unsigned long long start = traceNow();
+    sem_wait(&sync->master_access_mutex);
+    sem_wait(&sync->reader_count_mutex);
+    sync->active_readers_count++;
+    if (sync->active_readers_count == 1) sem_wait(&sync->game_state_mutex);
+    sem_post(&sync->reader_count_mutex);
+    sem_post(&sync->master_access_mutex);
+    traceSpan("reader lock", start);
+    decisionStart = traceNow();
+}
+
+void exitReader(game_sync_t *sync) {
+    traceSpan("decision", decisionStart);
+    sem_wait(&sync->reader_count_mutex);
+    sync->active_readers_count--;
+    if (sync->active_readers_count == 0) sem_post(&sync->game_state_mutex);
+    sem_post(&sync->reader_count_mutex);
+}
+
+// Toma la ficha de turno; sin bloquear devuelve 0 si todavía no llegó
+static int takeTurnToken(game_sync_t *sync, int playerListIndex, int block) {
+    if (sync->transport == TRANSPORT_MAILBOX) {
+        return futexSemWait(&sync->mailboxes[playerListIndex].turn, block ? -1 : 0) == 0;
+    }
+    if (block) {
+        return sem_wait(&(sync->player_move_token[playerListIndex])) == 0;
+    }
+    return sem_trywait(&(sync->player_move_token[playerListIndex])) == 0;
+}
+
+void awaitTurn(game_sync_t *sync, int playerListIndex) {
+    unsigned long long start = traceNow();
+    takeTurnToken(sync, playerListIndex, 1);
+    traceSpan("token wait", start);
+}
+
+void awaitTurnPondering(game_sync_t *sync, int playerListIndex, ponder_fn_t ponder, void *context) {
+    unsigned long long start = traceNow();
+    while (!takeTurnToken(sync, playerListIndex, 0)) {
+        // Cuando no queda nada por adelantar se espera la ficha normalmente
+        if (!ponder(context)) {
+            takeTurnToken(sync, playerListIndex, 1);
+            break;
+        }
+    }
+    traceSpan("token wait", start);
+}
+
+void submitMove(game_sync_t *sync, int playerListIndex, unsigned char move) {
+    unsigned long long start = traceNow();
+    if (sync->transport == TRANSPORT_MAILBOX) {
+        mailboxPublish(&sync->mailboxes[playerListIndex], move);
+        futexSemPost(&sync->master_doorbell);
+    } else {
+        write(STDOUT_FILENO, &move, sizeof(move));
+    }
+    traceSpan("write", start);
+}
+
 char (*getMoveMap())[3] {
     return moveMap;
 }
@@ -102,12 +190,13 @@ typedef struct {
     unsigned int depth;
 } Node;
 
-int bfsExplore(game_state_t *state, unsigned short startX, unsigned short startY, unsigned int maxDepth, int *exploredSpaces) {
-    if (startX >= state->width || startY >= state->height) return 0;
+// BFS sobre un tablero cualquiera, para poder explorar también copias privadas
+static int bfsOnBoard(const int *tablero, int width, int height, unsigned short startX, unsigned short startY, unsigned int maxDepth, int *exploredSpaces) {
+    if (startX >= width || startY >= height) return 0;
     int totalScore = 0;
     int count = 0;
 
-    int visited[state->height][state->width];
+    int visited[height][width];
     memset(visited, 0, sizeof(visited));
 
     int s = 2*maxDepth+1;
@@ -122,14 +211,14 @@ int bfsExplore(game_state_t *state, unsigned short startX, unsigned short startY
 
         for (int offY = -1; offY <= 1; offY++) {
             int y = current.y + offY;
-            if (y < 0 || y >= state->height) continue;
+            if (y < 0 || y >= height) continue;
 
             for (int offX = -1; offX <= 1; offX++) {
                 if (offX == 0 && offY == 0) continue;
                 int x = current.x + offX;
-                if (x < 0 || x >= state->width) continue;
+                if (x < 0 || x >= width) continue;
                 
-                int score = state->tablero[y*state->width+x];
+                int score = tablero[y*width+x];
                 if (visited[y][x] || score <= 0) continue;
 
                 visited[y][x] = 1;
@@ -143,9 +232,254 @@ int bfsExplore(game_state_t *state, unsigned short startX, unsigned short startY
     return totalScore;
 }
 
+int bfsExplore(game_state_t *state, unsigned short startX, unsigned short startY, unsigned int maxDepth, int *exploredSpaces) {
+    return bfsOnBoard(state->tablero, state->width, state->height, startX, startY, maxDepth, exploredSpaces);
+}
+
+// Cache de bfsExplore por celda. El resultado desde una celda solo depende de
+// las celdas a distancia de Chebyshev <= maxDepth, así que al cambiar una celda
+// basta invalidar el cuadrado de ese radio a su alrededor. Las celdas que
+// cambian son las que capturan los jugadores, una por movimiento válido, así
+// que se deducen de la posición y el contador de cada jugador sin recorrer el
+// tablero. Una partida nueva se reconoce por la generación del estado. Los
+// resultados se calculan sobre la copia del cache, así que
+// también sirven para pensar fuera del turno leyendo el tablero sin lock: la
+// próxima sincronización con el lock tomado invalida lo que haya cambiado.
+struct reach_cache {
+    unsigned int maxDepth;
+    unsigned short width, height;
+    unsigned int game;                         // Generación de partida de la copia
+    unsigned int seenValid[MAX_JUGADORES];     // validRequests de cada jugador en la última sincronización
+    unsigned short seenX[MAX_JUGADORES], seenY[MAX_JUGADORES];
+    int snapshot[MAX_WIDTH * MAX_HEIGHT];      // Tablero con el que se calcularon los resultados
+    int score[MAX_WIDTH * MAX_HEIGHT];
+    int explored[MAX_WIDTH * MAX_HEIGHT];
+    unsigned char valid[MAX_WIDTH * MAX_HEIGHT];
+};
+
+reach_cache_t *createReachCache(unsigned int maxDepth) {
+    reach_cache_t *cache = calloc(1, sizeof(reach_cache_t));
+    if (cache != NULL) {
+        cache->maxDepth = maxDepth;
+    }
+    return cache;
+}
+
+static void invalidateAround(reach_cache_t *cache, int cx, int cy) {
+    int r = cache->maxDepth;
+    int fromY = cy - r < 0 ? 0 : cy - r;
+    int toY = cy + r >= cache->height ? cache->height - 1 : cy + r;
+    int fromX = cx - r < 0 ? 0 : cx - r;
+    int toX = cx + r >= cache->width ? cache->width - 1 : cx + r;
+    for (int y = fromY; y <= toY; y++) {
+        memset(&cache->valid[y * cache->width + fromX], 0, toX - fromX + 1);
+    }
+}
+
+// Actualiza la copia en el cuadrado de radio r alrededor de una celda e
+// invalida alrededor de cada celda que cambió
+static void refreshAround(reach_cache_t *cache, game_state_t *state, int cx, int cy, int r) {
+    int fromY = cy - r < 0 ? 0 : cy - r;
+    int toY = cy + r >= cache->height ? cache->height - 1 : cy + r;
+    int fromX = cx - r < 0 ? 0 : cx - r;
+    int toX = cx + r >= cache->width ? cache->width - 1 : cx + r;
+    for (int y = fromY; y <= toY; y++) {
+        for (int x = fromX; x <= toX; x++) {
+            int idx = y * cache->width + x;
+            if (cache->snapshot[idx] != state->tablero[idx]) {
+                cache->snapshot[idx] = state->tablero[idx];
+                invalidateAround(cache, x, y);
+            }
+        }
+    }
+}
+
+static void rememberPlayer(reach_cache_t *cache, game_state_t *state, unsigned int id) {
+    cache->seenValid[id] = state->jugadores[id].validRequests;
+    cache->seenX[id] = state->jugadores[id].x;
+    cache->seenY[id] = state->jugadores[id].y;
+}
+
+void syncReachCache(reach_cache_t *cache, game_state_t *state) {
+    // Una generación impar es una partida a medio preparar: se sigue con la copia anterior
+    unsigned int game = __atomic_load_n(&state->game, __ATOMIC_ACQUIRE);
+    if (game & 1) return;
+    if (game != cache->game) {
+        // Si la partida cambia mientras se copia, la generación guardada ya no
+        // coincide y la próxima sincronización vuelve a copiar
+        cache->game = game;
+        cache->width = state->width;
+        cache->height = state->height;
+        memset(cache->valid, 0, sizeof(cache->valid));
+        memcpy(cache->snapshot, state->tablero, state->width * state->height * sizeof(int));
+        for (unsigned int i = 0; i < state->num_jugadores; i++) {
+            rememberPlayer(cache, state, i);
+        }
+        return;
+    }
+
+    // Con k movimientos nuevos, las celdas capturadas forman un camino que
+    // termina en la posición actual, así que están a distancia menor que k.
+    // Si la posición cambió sin que se viera el contador (lectura sin lock a
+    // mitad de un movimiento), se revisa igual la celda actual.
+    for (unsigned int i = 0; i < state->num_jugadores; i++) {
+        const jugador_t *player = &state->jugadores[i];
+        unsigned int moves = player->validRequests - cache->seenValid[i];
+        if (moves == 0 && player->x == cache->seenX[i] && player->y == cache->seenY[i]) continue;
+        refreshAround(cache, state, player->x, player->y, moves > 1 ? (int)moves - 1 : 0);
+        rememberPlayer(cache, state, i);
+    }
+}
+
+int cachedBfsExplore(reach_cache_t *cache, game_state_t *state, unsigned short x, unsigned short y, int *exploredSpaces) {
+    (void)state;
+    if (x >= cache->width || y >= cache->height) return 0;
+    int idx = y * cache->width + x;
+    if (!cache->valid[idx]) {
+        cache->score[idx] = bfsOnBoard(cache->snapshot, cache->width, cache->height, x, y, cache->maxDepth, &cache->explored[idx]);
+        cache->valid[idx] = 1;
+    }
+    if (exploredSpaces != NULL) *exploredSpaces = cache->explored[idx];
+    return cache->score[idx];
+}
+
+int ponderReachCache(reach_cache_t *cache, game_state_t *state, unsigned short x, unsigned short y) {
+    syncReachCache(cache, state);
+    if (x >= cache->width || y >= cache->height) return 0;
+
+    int computed = 0;
+    for (int d = 0; d < 8; d++) {
+        int nx = x + dirX[d];
+        int ny = y + dirY[d];
+        if (nx < 0 || nx >= cache->width || ny < 0 || ny >= cache->height) continue;
+        int idx = ny * cache->width + nx;
+        if (cache->valid[idx] || cache->snapshot[idx] <= 0) continue;
+        cachedBfsExplore(cache, state, nx, ny, NULL);
+        computed++;
+    }
+    return computed;
+}
+
+void releaseReachCache(reach_cache_t *cache) {
+    free(cache);
+}
+
+// Pool de hilos persistente para evaluateMoves. El hilo que llama también
+// evalúa candidatos; los hilos del pool duermen entre decisiones.
+#define MAX_EVAL_THREADS 7
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    int threads;            // Hilos creados, -1 si todavía no se intentó crear el pool
+    unsigned int batch;     // Se incrementa con cada lote publicado
+    int active;             // Hilos del pool trabajando en el lote actual
+    int next;               // Próximo candidato sin reclamar
+    int remaining;          // Candidatos sin terminar
+
+    // Lote actual
+    game_state_t *state;
+    unsigned short x, y;
+    move_scorer_t scorer;
+    void *context;
+    double *scores;
+    int count;
+    int dirs[8];
+} evalPool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, -1, 0, 0, 0, 0, NULL, 0, 0, NULL, NULL, NULL, 0, {0}};
+
+// Reclama y evalúa candidatos del lote actual hasta que no quede ninguno
+static void runEvalJobs() {
+    int i;
+    while ((i = __atomic_fetch_add(&evalPool.next, 1, __ATOMIC_ACQ_REL)) < evalPool.count) {
+        int d = evalPool.dirs[i];
+        evalPool.scores[d] = evalPool.scorer(evalPool.state, evalPool.x + dirX[d], evalPool.y + dirY[d], d, evalPool.context);
+        __atomic_fetch_sub(&evalPool.remaining, 1, __ATOMIC_ACQ_REL);
+    }
+}
+
+static void *evalWorker(void *arg) {
+    (void)arg;
+    unsigned int seen = 0;
+    pthread_mutex_lock(&evalPool.lock);
+    for (;;) {
+        while (evalPool.batch == seen) {
+            pthread_cond_wait(&evalPool.start, &evalPool.lock);
+        }
+        seen = evalPool.batch;
+        evalPool.active++;
+        pthread_mutex_unlock(&evalPool.lock);
+
+        runEvalJobs();
+
+        pthread_mutex_lock(&evalPool.lock);
+        if (--evalPool.active == 0) {
+            pthread_cond_signal(&evalPool.done);
+        }
+    }
+    return NULL;
+}
+
+// Crea los hilos la primera vez; si no se puede, se evalúa en serie.
+// Cuenta las CPUs permitidas y no las de la máquina, para no competir por una
+// sola CPU cuando el jugador está fijado (--pin-players, tune -a)
+static void startEvalPool() {
+    evalPool.threads = 0;
+    cpu_set_t allowed;
+    long cpus = sched_getaffinity(0, sizeof(allowed), &allowed) == 0 ? CPU_COUNT(&allowed)
+                                                                      : sysconf(_SC_NPROCESSORS_ONLN);
+    int wanted = cpus > 1 ? (int)cpus - 1 : 0;
+    if (wanted > MAX_EVAL_THREADS) wanted = MAX_EVAL_THREADS;
+
+    for (int i = 0; i < wanted; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, evalWorker, NULL) != 0) break;
+        pthread_detach(thread);
+        evalPool.threads++;
+    }
+}
+
+unsigned char evaluateMoves(game_state_t *state, unsigned short x, unsigned short y, move_scorer_t scorer, void *context, double scores[8]) {
+    unsigned char legal = legalMoves(state, x, y);
+    if (evalPool.threads < 0) startEvalPool();
+
+    pthread_mutex_lock(&evalPool.lock);
+    // Un hilo que despertó tarde para el lote anterior podría seguir reclamando
+    while (evalPool.active > 0) {
+        pthread_cond_wait(&evalPool.done, &evalPool.lock);
+    }
+    evalPool.state = state;
+    evalPool.x = x;
+    evalPool.y = y;
+    evalPool.scorer = scorer;
+    evalPool.context = context;
+    evalPool.scores = scores;
+    evalPool.count = 0;
+    for (int d = 0; d < 8; d++) {
+        if (legal & (1 << d)) evalPool.dirs[evalPool.count++] = d;
+    }
+    evalPool.next = 0;
+    evalPool.remaining = evalPool.count;
+    if (evalPool.threads > 0 && evalPool.count > 1) {
+        evalPool.batch++;
+        pthread_cond_broadcast(&evalPool.start);
+    }
+    pthread_mutex_unlock(&evalPool.lock);
+
+    runEvalJobs();
+
+    // Nadie puede seguir tocando el lote cuando se devuelve el control
+    pthread_mutex_lock(&evalPool.lock);
+    while (evalPool.active > 0 || __atomic_load_n(&evalPool.remaining, __ATOMIC_ACQUIRE) > 0) {
+        pthread_cond_wait(&evalPool.done, &evalPool.lock);
+    }
+    pthread_mutex_unlock(&evalPool.lock);
+    return legal;
+}
+
 void releaseState(game_state_t *state) {
     if (state != NULL) {
-        munmap(state, sizeof(game_state_t));
+        munmap(state, sessionShmSize(sizeof(game_state_t), sessionShmOptions()));
     }
 }
 
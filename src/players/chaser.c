@@ -13,16 +13,11 @@ int main() {
     jugador_t *playerData = getPlayer(state, getpid(), &playerListIndex);
     char (*moveMap)[3] = getMoveMap();
 
-    while(!playerData->stuck) {
+    while(stillPlaying(sync, playerData)) {
 
-        sem_wait(&(sync->player_move_token[playerListIndex]));
+        awaitTurn(sync, playerListIndex);
 
-        sem_wait(&sync->master_access_mutex);
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count++;
-        if (sync->active_readers_count == 1) sem_wait(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
-        sem_post(&sync->master_access_mutex);
+        enterReader(sync);
         
         int min = INT_MAX;
         int moveX = 0, moveY = 0;
@@ -48,13 +43,10 @@ int main() {
             }
         }
 
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count--;
-        if (sync->active_readers_count == 0) sem_post(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
+        exitReader(sync);
         
         unsigned char move = moveMap[moveY+1][moveX+1];
-        write(STDOUT_FILENO, &move, sizeof(move));
+        submitMove(sync, playerListIndex, move);
     }
     return 0;
 }
\ No newline at end of file
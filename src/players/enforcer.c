@@ -6,25 +6,23 @@
 #include <playerlib.h>
 #include <limits.h>
 
-#define CLOSE_THRESHOLD 6
+#define DEFAULT_CLOSE_THRESHOLD 6
+
+int main(int argc, char *argv[]) {
+    loadTuning(argc, argv);
+    int closeThreshold = (int)tuningParam("CLOSE_THRESHOLD", DEFAULT_CLOSE_THRESHOLD);
 
-int main() {
     game_state_t *state = getState();
     game_sync_t *sync = getSync();
     int playerListIndex;
     jugador_t *playerData = getPlayer(state, getpid(), &playerListIndex);
     char (*moveMap)[3] = getMoveMap();
 
-    while(!playerData->stuck) {
+    while(stillPlaying(sync, playerData)) {
 
-        sem_wait(&(sync->player_move_token[playerListIndex]));
+        awaitTurn(sync, playerListIndex);
 
-        sem_wait(&sync->master_access_mutex);
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count++;
-        if (sync->active_readers_count == 1) sem_wait(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
-        sem_post(&sync->master_access_mutex);
+        enterReader(sync);
         
         int max = 0;
         int min = INT_MAX;
@@ -60,7 +58,7 @@ int main() {
             }
         }
 
-        if (toClosest < CLOSE_THRESHOLD*CLOSE_THRESHOLD) {
+        if (toClosest < closeThreshold*closeThreshold) {
             moveX = escapeX;
             moveY = escapeY;
         }
@@ -69,13 +67,10 @@ int main() {
             moveY = chaseY;
         }
 
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count--;
-        if (sync->active_readers_count == 0) sem_post(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
+        exitReader(sync);
         
         unsigned char move = moveMap[moveY+1][moveX+1];
-        write(STDOUT_FILENO, &move, sizeof(move));
+        submitMove(sync, playerListIndex, move);
     }
     return 0;
 }
\ No newline at end of file
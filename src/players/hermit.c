@@ -13,31 +13,22 @@ int main() {
     jugador_t *playerData = getPlayer(state, getpid(), &playerListIndex);
     char (*moveMap)[3] = getMoveMap();
 
-    while(!playerData->stuck) {
+    while(stillPlaying(sync, playerData)) {
 
-        sem_wait(&(sync->player_move_token[playerListIndex]));
+        awaitTurn(sync, playerListIndex);
 
-        sem_wait(&sync->master_access_mutex);
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count++;
-        if (sync->active_readers_count == 1) sem_wait(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
-        sem_post(&sync->master_access_mutex);
+        enterReader(sync);
         
         int max = 0;
         int moveX = 0, moveY = 0;
+        unsigned char legal = legalMoves(state, playerData->x, playerData->y);
         for (int offY = -1; offY <= 1; offY++)
         {
-            int y = playerData->y + offY;
-            if (y < 0 || y >= state->height) continue;
-
             for (int offX = -1; offX <= 1; offX++)
             {
-                if (offX == 0 && offY == 0) continue;
+                if (!(legal & (1 << moveMap[offY+1][offX+1]))) continue;
                 int x = playerData->x + offX;
-                if (x < 0 || x >= state->width) continue;
-
-                if (state->tablero[y * state->width + x] <= 0) continue;
+                int y = playerData->y + offY;
 
                 int distance = sqrDistClosestOther(state, playerListIndex, x, y);
                 if (distance > max) {
@@ -48,13 +39,10 @@ int main() {
             }
         }
 
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count--;
-        if (sync->active_readers_count == 0) sem_post(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
+        exitReader(sync);
         
         unsigned char move = moveMap[moveY+1][moveX+1];
-        write(STDOUT_FILENO, &move, sizeof(move));
+        submitMove(sync, playerListIndex, move);
     }
     return 0;
 }
\ No newline at end of file
@@ -5,14 +5,17 @@
 #include <unistd.h>
 #include <signal.h>
 #include <playerlib.h>
+#include <chambers.h>
+#include <endgame.h>
 #include <math.h>
 
 #define EPSILON 1e-4
 
-#define BFS_DEPTH 10
-#define FREEDOM_BIAS 10
-#define SCORE_BIAS 5
-#define IMMEDIATE_FREEDOM_BIAS ((2*BFS_DEPTH+1)*(2*BFS_DEPTH+1))
+// Valores por defecto; se pueden ajustar con tuningParam (ver tune)
+#define DEFAULT_BFS_DEPTH 10
+#define DEFAULT_FREEDOM_BIAS 10
+#define DEFAULT_SCORE_BIAS 5
+#define DEFAULT_IMMEDIATE_FREEDOM_BIAS ((2*bfsDepth+1)*(2*bfsDepth+1))
 
 // Global variables for cleanup
 static game_state_t *g_state = NULL;
@@ -24,7 +27,26 @@ void cleanup_handler(int sig) {
     _exit(0);
 }
 
-int main() {
+typedef struct {
+    reach_cache_t *cache;
+    game_state_t *state;
+    jugador_t *player;
+} ponder_context_t;
+
+// Mientras juegan los demás, adelanta el BFS de los vecinos de la posición actual
+static int ponder(void *context) {
+    ponder_context_t *ctx = context;
+    return ponderReachCache(ctx->cache, ctx->state, ctx->player->x, ctx->player->y);
+}
+
+int main(int argc, char *argv[]) {
+    loadTuning(argc, argv);
+    int bfsDepth = (int)tuningParam("BFS_DEPTH", DEFAULT_BFS_DEPTH);
+    if (bfsDepth < 1) bfsDepth = 1;
+    double freedomBias = tuningParam("FREEDOM_BIAS", DEFAULT_FREEDOM_BIAS);
+    double scoreBias = tuningParam("SCORE_BIAS", DEFAULT_SCORE_BIAS);
+    double immediateFreedomBias = tuningParam("IMMEDIATE_FREEDOM_BIAS", DEFAULT_IMMEDIATE_FREEDOM_BIAS);
+
     // Set up signal handlers for cleanup
     signal(SIGTERM, cleanup_handler);
     signal(SIGINT, cleanup_handler);
@@ -48,43 +70,59 @@ int main() {
         return 1;
     }
     char (*moveMap)[3] = getMoveMap();
+    reach_cache_t *reachCache = createReachCache(bfsDepth);
+    chamber_analyzer_t *chambers = createChamberAnalyzer();
+    endgame_solver_t *endgame = createEndgameSolver();
+    if (!reachCache || !chambers || !endgame) {
+        releaseState(state);
+        releaseSync(sync);
+        return 1;
+    }
+
+    ponder_context_t ponderContext = {reachCache, state, playerData};
 
-    while(!playerData->stuck) {
+    while(stillPlaying(sync, playerData)) {
 
-        sem_wait(&(sync->player_move_token[playerListIndex]));
+        awaitTurnPondering(sync, playerListIndex, ponder, &ponderContext);
 
-        sem_wait(&sync->master_access_mutex);
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count++;
-        if (sync->active_readers_count == 1) sem_wait(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
-        sem_post(&sync->master_access_mutex);
+        enterReader(sync);
+        syncReachCache(reachCache, state);
+
+        // Aislado de los rivales, el mejor recorrido se puede calcular directamente
+        endgame_result_t solution;
+        if (solveEndgame(endgame, state, playerListIndex, &solution)) {
+            exitReader(sync);
+            submitMove(sync, playerListIndex, solution.move);
+            continue;
+        }
+
+        // El BFS no distingue bolsillos sin salida; la cámara acota el espacio real
+        chamber_info_t chamber[8];
+        analyzeMoves(chambers, state, playerData->x, playerData->y, chamber);
 
         char ties[8][2] = {0};
         int tieIndex = 0;
 
         double max = -1;
         int moveX = 0, moveY = 0;
+        unsigned char legal = legalMoves(state, playerData->x, playerData->y);
         for (int offY = -1; offY <= 1; offY++)
         {
-            int y = playerData->y + offY;
-            if (y < 0 || y >= state->height) continue;
-
             for (int offX = -1; offX <= 1; offX++)
             {
-                if (offX == 0 && offY == 0) continue;
+                if (!(legal & (1 << moveMap[offY+1][offX+1]))) continue;
                 int x = playerData->x + offX;
-                if (x < 0 || x >= state->width) continue;
-
-                if (state->tablero[y * state->width + x] <= 0) continue;
+                int y = playerData->y + offY;
 
                 int immediateFreedom = freeNeighborCount(state, x, y);
                 int freedom;
-                int potentialScore = bfsExplore(state, x, y, BFS_DEPTH, &freedom);
+                int potentialScore = cachedBfsExplore(reachCache, state, x, y, &freedom);
+                int chamberCells = chamber[(int)moveMap[offY+1][offX+1]].cells - 1;
+                if (chamberCells < freedom) freedom = chamberCells;
 
-                double rating = (double)FREEDOM_BIAS * (double)freedom +
-                                (double)SCORE_BIAS * (double)potentialScore +
-                                (double)IMMEDIATE_FREEDOM_BIAS * (double)immediateFreedom;
+                double rating = freedomBias * (double)freedom +
+                                scoreBias * (double)potentialScore +
+                                immediateFreedomBias * (double)immediateFreedom;
 
                 if (fabs(rating - max) < EPSILON) {
                     ties[tieIndex][0] = offX;
@@ -118,13 +156,13 @@ int main() {
             }
         }
 
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count--;
-        if (sync->active_readers_count == 0) sem_post(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
+        exitReader(sync);
         
         unsigned char move = moveMap[moveY+1][moveX+1];
-        write(STDOUT_FILENO, &move, sizeof(move));
+        submitMove(sync, playerListIndex, move);
     }
+    releaseReachCache(reachCache);
+    releaseChamberAnalyzer(chambers);
+    releaseEndgameSolver(endgame);
     return 0;
 }
\ No newline at end of file
@@ -22,11 +22,11 @@ int main() {
     int playerListIndex;
     jugador_t *playerData = getPlayer(state, getpid(), &playerListIndex);
 
-    while(!playerData->stuck) {
-        sem_wait(&(sync->player_move_token[playerListIndex]));
+    while(stillPlaying(sync, playerData)) {
+        awaitTurn(sync, playerListIndex);
 
         unsigned char move = randInt(0,8);
-        write(STDOUT_FILENO, &move, sizeof(move));
+        submitMove(sync, playerListIndex, move);
     }
     return 0;
 }
\ No newline at end of file
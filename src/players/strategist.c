@@ -8,12 +8,18 @@
 #include <limits.h>
 #include <math.h>
 
-// Constantes para el algoritmo de estrategia
-#define HORIZON_DEPTH 6        // Profundidad máxima de búsqueda en el horizonte
-#define DECAY_FACTOR 0.8       // Factor de decaimiento para la distancia
-#define VORONOI_WEIGHT 0.6     // Peso del factor de territorio Voronoi
-#define HORIZON_WEIGHT 0.4     // Peso del potencial del horizonte
-#define EPSILON 1e-4           // Tolerancia para comparaciones de punto flotante
+// Constantes para el algoritmo de estrategia (valores por defecto de tuningParam)
+#define DEFAULT_HORIZON_DEPTH 6      // Profundidad máxima de búsqueda en el horizonte
+#define DEFAULT_DECAY_FACTOR 0.8     // Factor de decaimiento para la distancia
+#define DEFAULT_VORONOI_WEIGHT 0.6   // Peso del factor de territorio Voronoi
+#define DEFAULT_HORIZON_WEIGHT 0.4   // Peso del potencial del horizonte
+#define EPSILON 1e-4                 // Tolerancia para comparaciones de punto flotante
+
+// Parámetros efectivos, leídos al iniciar
+static int horizonDepth = DEFAULT_HORIZON_DEPTH;
+static double decayFactor = DEFAULT_DECAY_FACTOR;
+static double voronoiWeight = DEFAULT_VORONOI_WEIGHT;
+static double horizonWeight = DEFAULT_HORIZON_WEIGHT;
 
 // Variables globales para limpieza
 static game_state_t *g_state = NULL;
@@ -78,7 +84,7 @@ double calculateHorizonPotential(game_state_t *state, int startX, int startY, un
     while (queueHead < queueTail) {
         QueueNode current = queue[queueHead++];
         
-        if (current.depth >= HORIZON_DEPTH) continue;
+        if (current.depth >= horizonDepth) continue;
         
         // Verificar las 8 direcciones
         for (int offY = -1; offY <= 1; offY++) {
@@ -106,7 +112,7 @@ double calculateHorizonPotential(game_state_t *state, int startX, int startY, un
                 // Calcular potencial con decaimiento por distancia
                 double decay = 1.0;
                 for (int d = 0; d < current.depth + 1; d++) {
-                    decay *= DECAY_FACTOR;
+                    decay *= decayFactor;
                 }
                 double voronoiBonus = isVoronoiTerritory(state, myPlayerId, newX, newY) ? 1.5 : 1.0;
                 totalPotential += cellValue * decay * voronoiBonus;
@@ -145,12 +151,25 @@ double calculateMoveUtility(game_state_t *state, unsigned int myPlayerId, int mo
     }
     
     // Combinar ambos factores
-    double utility = VORONOI_WEIGHT * voronoiValue + HORIZON_WEIGHT * horizonPotential;
+    double utility = voronoiWeight * voronoiValue + horizonWeight * horizonPotential;
     
     return utility;
 }
 
-int main() {
+// Adaptador de calculateMoveUtility para evaluateMoves
+static double scoreMove(game_state_t *state, unsigned short x, unsigned short y, int direction, void *context) {
+    (void)direction;
+    unsigned int myPlayerId = *(unsigned int *)context;
+    return calculateMoveUtility(state, myPlayerId, x - state->jugadores[myPlayerId].x, y - state->jugadores[myPlayerId].y);
+}
+
+int main(int argc, char *argv[]) {
+    loadTuning(argc, argv);
+    horizonDepth = (int)tuningParam("HORIZON_DEPTH", DEFAULT_HORIZON_DEPTH);
+    decayFactor = tuningParam("DECAY_FACTOR", DEFAULT_DECAY_FACTOR);
+    voronoiWeight = tuningParam("VORONOI_WEIGHT", DEFAULT_VORONOI_WEIGHT);
+    horizonWeight = tuningParam("HORIZON_WEIGHT", DEFAULT_HORIZON_WEIGHT);
+
     // Configurar manejadores de señales para limpieza
     signal(SIGTERM, cleanup_handler);
     signal(SIGINT, cleanup_handler);
@@ -175,34 +194,29 @@ int main() {
     }
     char (*moveMap)[3] = getMoveMap();
 
-    while(!playerData->stuck) {
-        sem_wait(&(sync->player_move_token[playerListIndex]));
+    while(stillPlaying(sync, playerData)) {
+        awaitTurn(sync, playerListIndex);
 
-        sem_wait(&sync->master_access_mutex);
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count++;
-        if (sync->active_readers_count == 1) sem_wait(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
-        sem_post(&sync->master_access_mutex);
+        enterReader(sync);
 
         // Encontrar el mejor movimiento usando estrategia VPH
         double maxUtility = -1.0;
         int bestMoveX = 0, bestMoveY = 0;
         int bestFreeNeighbors = -1;
-        
-        // Verificar las 8 direcciones + quedarse (0,0)
-        for (int offY = -1; offY <= 1; offY++) {
-            int y = playerData->y + offY;
-            if (y < 0 || y >= state->height) continue;
 
+        // Las utilidades se calculan en paralelo; la elección sigue el orden de siempre
+        unsigned int myPlayerId = playerListIndex;
+        double utilities[8];
+        unsigned char legal = evaluateMoves(state, playerData->x, playerData->y, scoreMove, &myPlayerId, utilities);
+
+        for (int offY = -1; offY <= 1; offY++) {
             for (int offX = -1; offX <= 1; offX++) {
-                if (offX == 0 && offY == 0) continue;
+                int direction = moveMap[offY+1][offX+1];
+                if (!(legal & (1 << direction))) continue;
                 int x = playerData->x + offX;
-                if (x < 0 || x >= state->width) continue;
-
-                if (state->tablero[y * state->width + x] <= 0) continue;
+                int y = playerData->y + offY;
 
-                double utility = calculateMoveUtility(state, playerListIndex, offX, offY);
+                double utility = utilities[direction];
                 
                 // Calcular vecinos libres para desempate
                 int freeNeighbors = freeNeighborCount(state, x, y);
@@ -218,13 +232,10 @@ int main() {
             }
         }
 
-        sem_wait(&sync->reader_count_mutex);
-        sync->active_readers_count--;
-        if (sync->active_readers_count == 0) sem_post(&sync->game_state_mutex);
-        sem_post(&sync->reader_count_mutex);
+        exitReader(sync);
         
         unsigned char move = moveMap[bestMoveY+1][bestMoveX+1];
-        write(STDOUT_FILENO, &move, sizeof(move));
+        submitMove(sync, playerListIndex, move);
     }
     return 0;
 }
@@ -0,0 +1,139 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _DEFAULT_SOURCE
+#include <ratings.h>
+#include <score.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+int openRatings(ratings_t *ratings, const char *path, int writable) {
+    ratings->fd = open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    ratings->store = NULL;
+    if (ratings->fd == -1) return -1;
+
+    // El lock exclusivo evita que dos másters inicialicen el mismo archivo a la vez
+    flock(ratings->fd, writable ? LOCK_EX : LOCK_SH);
+    struct stat st;
+    int error = 0;
+    if (fstat(ratings->fd, &st) == -1) {
+        error = errno;
+    } else if (st.st_size == 0 && writable) {
+        if (ftruncate(ratings->fd, sizeof(rating_store_t)) == -1) error = errno;
+    } else if (st.st_size != sizeof(rating_store_t)) {
+        error = EINVAL;
+    }
+
+    if (!error) {
+        ratings->store = mmap(NULL, sizeof(rating_store_t), writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, ratings->fd, 0);
+        if (ratings->store == MAP_FAILED) {
+            error = errno;
+            ratings->store = NULL;
+        }
+    }
+
+    if (!error && ratings->store->magic == 0 && writable) {
+        ratings->store->magic = RATINGS_MAGIC;
+        ratings->store->version = RATINGS_VERSION;
+        ratings->store->capacity = RATINGS_CAPACITY;
+    }
+    if (!error && (ratings->store->magic != RATINGS_MAGIC || ratings->store->version != RATINGS_VERSION)) {
+        error = EINVAL;
+    }
+    flock(ratings->fd, LOCK_UN);
+
+    if (error) {
+        closeRatings(ratings);
+        errno = error;
+        return -1;
+    }
+    return 0;
+}
+
+// Busca la entrada de un nombre, agregándola al final si es nueva
+static int entryFor(rating_store_t *store, const char *name) {
+    for (unsigned int i = 0; i < store->count; i++) {
+        if (strncmp(store->entries[i].name, name, PLAYER_NAME_LENGTH) == 0) return i;
+    }
+    if (store->count == store->capacity) return -1;
+
+    rating_entry_t *entry = &store->entries[store->count];
+    memset(entry, 0, sizeof(*entry));
+    strncpy(entry->name, name, PLAYER_NAME_LENGTH - 1);
+    entry->rating = RATING_INITIAL;
+    return store->count++;
+}
+
+int recordGame(ratings_t *ratings, game_state_t *state) {
+    if (flock(ratings->fd, LOCK_EX) == -1) return -1;
+    rating_store_t *store = ratings->store;
+    int n = state->num_jugadores;
+
+    int entry[MAX_JUGADORES];
+    double delta[MAX_JUGADORES] = {0};
+    for (int i = 0; i < n; i++) {
+        entry[i] = entryFor(store, state->jugadores[i].nombre);
+    }
+
+    // Todas las expectativas salen de los ratings previos a la partida
+    double k = n > 1 ? RATING_K / (n - 1) : 0;
+    for (int a = 0; a < n; a++) {
+        for (int b = a + 1; b < n; b++) {
+            int i = state->ranking[a], j = state->ranking[b];
+            if (entry[i] < 0 || entry[j] < 0 || entry[i] == entry[j]) continue;
+
+            double ri = store->entries[entry[i]].rating;
+            double rj = store->entries[entry[j]].rating;
+            double expected = 1.0 / (1.0 + pow(10.0, (rj - ri) / 400.0));
+            double actual = comparePlayers(state->jugadores[i], state->jugadores[j]) == 0 ? 0.5 : 1.0;
+            delta[i] += k * (actual - expected);
+            delta[j] -= k * (actual - expected);
+        }
+    }
+
+    // Cada entrada se actualiza una vez por partida. Recorriendo el ranking,
+    // el primer asiento de cada binario es el mejor ubicado y es el que cuenta
+    // para partidas, puntaje y victorias; el rating suma los deltas de todos
+    jugador_t *leader = &state->jugadores[state->ranking[0]];
+    for (int a = 0; a < n; a++) {
+        int i = state->ranking[a];
+        if (entry[i] < 0) continue;
+        rating_entry_t *e = &store->entries[entry[i]];
+        int first = 1;
+        for (int b = 0; b < a; b++) {
+            if (entry[state->ranking[b]] == entry[i]) first = 0;
+        }
+        if (!first) continue;
+
+        for (int j = 0; j < n; j++) {
+            if (entry[j] == entry[i]) e->rating += delta[j];
+        }
+        e->games++;
+        e->score += state->jugadores[i].puntaje;
+        if (comparePlayers(state->jugadores[i], *leader) == 0) e->wins++;
+    }
+    store->games++;
+
+    flock(ratings->fd, LOCK_UN);
+    return 0;
+}
+
+void lockRatings(ratings_t *ratings, int locked) {
+    flock(ratings->fd, locked ? LOCK_SH : LOCK_UN);
+}
+
+void closeRatings(ratings_t *ratings) {
+    if (ratings->store != NULL) {
+        munmap(ratings->store, sizeof(rating_store_t));
+        ratings->store = NULL;
+    }
+    if (ratings->fd != -1) {
+        close(ratings->fd);
+        ratings->fd = -1;
+    }
+}
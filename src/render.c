@@ -0,0 +1,300 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#include <stdio.h>
+#include <stdlib.h>
+#include <render.h>
+#include <score.h>
+
+/**
+ * @brief Códigos de color para salida de terminal
+ * 
+ * Arreglo de secuencias de escape ANSI para mostrar diferentes jugadores
+ * en diferentes colores. Soporta hasta 9 jugadores (MAX_JUGADORES).
+ */
+static const char* colors[] = {
+    "\033[34m",  // Azul
+    "\033[31m",  // Rojo
+    "\033[32m",  // Verde
+    "\033[33m",  // Amarillo
+    "\033[35m",  // Magenta
+    "\033[36m",  // Cian
+    "\033[37m",  // Blanco
+    "\033[90m",  // Gris Oscuro
+    "\033[93m"   // Amarillo Claro
+};
+
+/**
+ * @brief Colores de la paleta de 256 colores para la vista general
+ * 
+ * Siguen el mismo orden que colors para que cada jugador conserve su color.
+ */
+static const int overviewColors[] = {33, 196, 46, 226, 201, 51, 255, 244, 229};
+
+#define OVERVIEW_OUTSIDE 16     // Negro, fuera del tablero
+#define OVERVIEW_HEAT_BASE 236  // Gris del valor libre promedio más bajo
+
+void printAnimatedBar(int length, int frame) {
+    // Barra animada para mostrar que el juego sigue corriendo
+    int pos = ((frame % 10) + 10) % 10;
+    for (int i = 0; i < length; i++)
+    {
+        if (i%10 != pos) putchar('-');
+        else putchar('|');
+        putchar(' ');
+    }
+    putchar('\n');
+}
+
+void printEndgameBar(int length) {
+    for (int i = 0; i < length-1; i++)
+    {
+        printf("==");
+    }
+    printf("=\n");
+}
+
+void drawBoard(game_state_t *state) {
+    if (!state || state->width <= 0 || state->height <= 0) {
+        printf("Error: Estado de juego inválido o dimensiones incorrectas\n");
+        return;
+    }
+    
+    for (int y=0; y<state->height; y++) {
+        for (int x=0; x<state->width; x++) {
+            int val = state->tablero[y * state->width + x];
+            
+            // Verificar si hay un jugador en esta posición actual
+            int current_player = -1;
+            for (size_t i = 0; i < state->num_jugadores; i++) {
+                if (state->jugadores[i].x == x && state->jugadores[i].y == y) {
+                    current_player = i;
+                    break;
+                }
+            }
+            
+            if (current_player != -1) {
+                // Posición actual de un jugador: mostrar letra coloreada
+                char player_char = 'A' + current_player;
+                if (current_player < 9) {
+                    printf("%s%c\033[0m ", colors[current_player], player_char);
+                } else {
+                    printf("%c ", player_char);  // Fallabck para índice de jugador inválido
+                }
+            } else if (val <= 0) {
+                // Posiciones visitadas: 0 para jugador 0, -i para jugador i
+                int player_id = -val;
+                
+                if (player_id < 9) {
+                    printf("%s.\033[0m ", colors[player_id]);
+                } else {
+                    printf(". ");  // Fallback
+                }
+            } else {
+                // Casilleros no visitados: mostrar valores (incluye 0)
+                printf("%d ", val);
+            }
+        }
+        putchar('\n');
+    }
+}
+
+// Color de un píxel que cubre las celdas [x0, x1) x [y0, y1)
+static int overviewPixel(game_state_t *state, int x0, int y0, int x1, int y1) {
+    unsigned int owned[MAX_JUGADORES] = {0};
+    unsigned int cells = 0, freeValue = 0;
+
+    if (x1 - x0 >= TILE_SIZE && y1 - y0 >= TILE_SIZE) {
+        // Píxel de al menos un bloque: alcanza con los agregados
+        for (int ty = y0 / TILE_SIZE; ty <= (y1 - 1) / TILE_SIZE; ty++) {
+            int tileHeight = state->height - ty * TILE_SIZE < TILE_SIZE ? state->height - ty * TILE_SIZE : TILE_SIZE;
+            for (int tx = x0 / TILE_SIZE; tx <= (x1 - 1) / TILE_SIZE; tx++) {
+                int tileWidth = state->width - tx * TILE_SIZE < TILE_SIZE ? state->width - tx * TILE_SIZE : TILE_SIZE;
+                int tile = ty * TILE_COLS + tx;
+                cells += tileWidth * tileHeight;
+                freeValue += state->tile_free_value[tile];
+                for (size_t p = 0; p < state->num_jugadores; p++) {
+                    owned[p] += state->tile_owned[tile][p];
+                }
+            }
+        }
+    } else {
+        // Píxel más chico que un bloque: se leen sus pocas celdas
+        for (int y = y0; y < y1; y++) {
+            for (int x = x0; x < x1; x++) {
+                int val = state->tablero[y * state->width + x];
+                cells++;
+                if (val > 0) freeValue += val;
+                else if (-val < MAX_JUGADORES) owned[-val]++;
+            }
+        }
+    }
+
+    unsigned int ownedTotal = 0;
+    int owner = 0;
+    for (size_t p = 0; p < state->num_jugadores; p++) {
+        ownedTotal += owned[p];
+        if (owned[p] > owned[owner]) owner = p;
+    }
+    if (cells == 0) return OVERVIEW_OUTSIDE;
+    if (ownedTotal * 2 > cells) return overviewColors[owner];
+
+    // Valor libre promedio entre 1 y 9: más claro cuanto más vale la zona
+    unsigned int average = freeValue / (cells - ownedTotal);
+    return OVERVIEW_HEAT_BASE + 2 * (average > 9 ? 9 : average);
+}
+
+/**
+ * @brief Ventana del tablero y escala de una vista general
+ */
+typedef struct {
+    int viewX, viewY;           ///< Primera celda de la ventana
+    double scale;               ///< Celdas por píxel, igual en ambos ejes
+    int pixelsX, pixelsY;       ///< Píxeles dibujados
+} overview_layout_t;
+
+static void overviewLayout(game_state_t *state, const overview_t *overview, overview_layout_t *layout) {
+    // Ventana del tablero a mostrar: todo, o un cuadrado alrededor del jugador seguido
+    int viewX = 0, viewY = 0, viewWidth = state->width, viewHeight = state->height;
+    if (overview->follow >= 0 && (size_t)overview->follow < state->num_jugadores && overview->viewport > 0) {
+        jugador_t *player = &state->jugadores[overview->follow];
+        if (overview->viewport < viewWidth) {
+            viewWidth = overview->viewport;
+            viewX = player->x - viewWidth / 2;
+            if (viewX < 0) viewX = 0;
+            if (viewX > state->width - viewWidth) viewX = state->width - viewWidth;
+        }
+        if (overview->viewport < viewHeight) {
+            viewHeight = overview->viewport;
+            viewY = player->y - viewHeight / 2;
+            if (viewY < 0) viewY = 0;
+            if (viewY > state->height - viewHeight) viewY = state->height - viewHeight;
+        }
+    }
+
+    // Celdas por píxel, igual en ambos ejes para no deformar el tablero
+    double scale = (double)viewWidth / overview->cols;
+    if ((double)viewHeight / (overview->rows * 2) > scale) scale = (double)viewHeight / (overview->rows * 2);
+    if (scale < 1.0) scale = 1.0;
+    layout->viewX = viewX;
+    layout->viewY = viewY;
+    layout->scale = scale;
+    layout->pixelsX = viewWidth / scale < 1 ? 1 : (int)(viewWidth / scale);
+    layout->pixelsY = viewHeight / scale < 1 ? 1 : (int)(viewHeight / scale);
+}
+
+int overviewColumns(game_state_t *state, const overview_t *overview) {
+    overview_layout_t layout;
+    overviewLayout(state, overview, &layout);
+    return layout.pixelsX;
+}
+
+void drawOverview(game_state_t *state, const overview_t *overview) {
+    if (!state || !overview || state->width <= 0 || state->height <= 0 || overview->cols <= 0 || overview->rows <= 0) {
+        printf("Error: Estado de juego inválido o vista general sin tamaño\n");
+        return;
+    }
+
+    overview_layout_t layout;
+    overviewLayout(state, overview, &layout);
+    int viewX = layout.viewX, viewY = layout.viewY;
+    int pixelsX = layout.pixelsX, pixelsY = layout.pixelsY;
+    double scale = layout.scale;
+
+    // Carácter de la posición actual de cada jugador dentro de la ventana
+    int headCol[MAX_JUGADORES], headRow[MAX_JUGADORES];
+    for (size_t p = 0; p < state->num_jugadores; p++) {
+        int px = (int)((state->jugadores[p].x - viewX) / scale);
+        int py = (int)((state->jugadores[p].y - viewY) / scale);
+        int inside = state->jugadores[p].x >= viewX && state->jugadores[p].y >= viewY && px < pixelsX && py < pixelsY;
+        headCol[p] = inside ? px : -1;
+        headRow[p] = inside ? py / 2 : -1;
+    }
+
+    for (int row = 0; row * 2 < pixelsY; row++) {
+        int lastTop = -1, lastBottom = -1;
+        for (int col = 0; col < pixelsX; col++) {
+            int x0 = viewX + (int)(col * scale), x1 = viewX + (int)((col + 1) * scale);
+            int head = -1;
+            for (size_t p = 0; p < state->num_jugadores; p++) {
+                if (headCol[p] == col && headRow[p] == row) head = p;
+            }
+            if (head >= 0) {
+                printf("\033[30;48;5;%dm%c", overviewColors[head], 'A' + head);
+                lastTop = lastBottom = -1;
+                continue;
+            }
+
+            int top = overviewPixel(state, x0, viewY + (int)(row * 2 * scale), x1, viewY + (int)((row * 2 + 1) * scale));
+            int bottom = row * 2 + 1 < pixelsY
+                ? overviewPixel(state, x0, viewY + (int)((row * 2 + 1) * scale), x1, viewY + (int)((row * 2 + 2) * scale))
+                : OVERVIEW_OUTSIDE;
+            // Solo se emiten los cambios de color para acotar la salida
+            if (top != lastTop) printf("\033[38;5;%dm", top);
+            if (bottom != lastBottom) printf("\033[48;5;%dm", bottom);
+            lastTop = top;
+            lastBottom = bottom;
+            fputs("\u2580", stdout);
+        }
+        printf("\033[0m\n");
+    }
+}
+
+void printStatus(game_state_t *state, char *title) {
+    if (!state || !title) {
+        printf("Error: Parámetros inválidos para printStatus\n");
+        return;
+    }
+    
+    printf("\n%28s\n", title);
+    jugador_t *players = state->jugadores;
+
+    for (size_t i = 0; i < state->num_jugadores; i++) {
+        int id = state->ranking[i];
+        printf("%s%-16s\033[0m | %4u p | (%2d,%2d) |",
+                (id < 9) ? colors[id] : "",
+                players[id].nombre,
+                players[id].puntaje,
+                players[id].x,
+                players[id].y);
+        if (players[id].stuck) {
+            printf(" %s(x_x)\033[0m", (id < 9) ? colors[id] : "");
+        }
+        putchar('\n');
+    }
+}
+
+void gameEnded(game_state_t *state, const overview_t *overview) {
+    if (!state) {
+        printf("Error: Estado de juego inválido para gameEnded\n");
+        return;
+    }
+    
+    printStatus(state, "=== Game over ===");
+    putchar('\n');
+
+    int barLength = overview ? (overviewColumns(state, overview) + 1) / 2 : state->width;
+    printEndgameBar(barLength);
+    if (overview) drawOverview(state, overview);
+    else drawBoard(state);
+    printEndgameBar(barLength);
+    
+    // Ganan el primero del ranking y quienes empatan con él
+    size_t winners[state->num_jugadores];
+    size_t winnerCount = 0;
+    jugador_t leader = state->jugadores[state->ranking[0]];
+
+    for (size_t i = 0; i < state->num_jugadores; i++) {
+        int id = state->ranking[i];
+        if (comparePlayers(state->jugadores[id], leader) != 0) break;
+        winners[winnerCount++] = id;
+    }
+
+    printf("\n=== Winner%s: [ ", winnerCount > 1 ? "s" : "");
+    for (size_t i = 0; i < winnerCount; i++) {
+        int idx = winners[i];
+        char *color = idx < 9 ? colors[idx] : "";
+        printf("%s%s\033[0m", color, state->jugadores[idx].nombre);
+        if (i < winnerCount-1) printf(", ");
+    }
+    printf(" ] ===\n");
+}
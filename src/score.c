@@ -1,21 +1,77 @@
 // This is a personal academic project. Dear PVS-Studio, please check it.
 // PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
 #include <score.h>
+#include <string.h>
+
+// Compara sin restar: la resta de unsigned puede desbordar el int resultado
+static int compareCounts(unsigned int a, unsigned int b) {
+    return (a > b) - (a < b);
+}
 
 int comparePlayers(jugador_t j1, jugador_t j2) {
     // 1. Mayor puntaje gana (orden descendente)
-    int cmp = j1.puntaje - j2.puntaje;
+    int cmp = compareCounts(j1.puntaje, j2.puntaje);
     if (cmp == 0) {
         // 2. En caso de empate, menor cantidad de movimientos válidos gana (mayor eficiencia)
-        cmp = j2.validRequests - j1.validRequests;
+        cmp = compareCounts(j2.validRequests, j1.validRequests);
         if (cmp == 0) {
             // 3. Si persiste el empate, menor cantidad de movimientos inválidos gana
-            cmp = j2.invalidRequests - j1.invalidRequests;
+            cmp = compareCounts(j2.invalidRequests, j1.invalidRequests);
         }
     }
     return cmp;
 }
 
+// Orden total del ranking: ante un empate completo va primero el ID menor
+static int ranksBefore(game_state_t *state, int a, int b) {
+    int cmp = comparePlayers(state->jugadores[a], state->jugadores[b]);
+    return cmp > 0 || (cmp == 0 && a < b);
+}
+
+void initRanking(game_state_t *state) {
+    int n = state->num_jugadores;
+    for (int i = 0; i < n; i++) {
+        // Inserción: con a lo sumo MAX_JUGADORES jugadores alcanza
+        int j = i;
+        while (j > 0 && ranksBefore(state, i, state->ranking[j - 1])) {
+            state->ranking[j] = state->ranking[j - 1];
+            j--;
+        }
+        state->ranking[j] = i;
+    }
+}
+
+void updateRanking(game_state_t *state, int playerId) {
+    int n = state->num_jugadores;
+    int *ranking = state->ranking;
+    int pos = 0;
+    while (ranking[pos] != playerId) pos++;
+
+    // El resto sigue ordenado; se busca binariamente el nuevo lugar del jugador
+    int lo, hi;
+    if (pos > 0 && ranksBefore(state, playerId, ranking[pos - 1])) {
+        lo = 0;
+        hi = pos - 1;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (ranksBefore(state, playerId, ranking[mid])) hi = mid;
+            else lo = mid + 1;
+        }
+        memmove(&ranking[lo + 1], &ranking[lo], (pos - lo) * sizeof(int));
+        ranking[lo] = playerId;
+    } else if (pos < n - 1 && ranksBefore(state, ranking[pos + 1], playerId)) {
+        lo = pos + 1;
+        hi = n - 1;
+        while (lo < hi) {
+            int mid = (lo + hi + 1) / 2;
+            if (ranksBefore(state, ranking[mid], playerId)) lo = mid;
+            else hi = mid - 1;
+        }
+        memmove(&ranking[pos], &ranking[pos + 1], (lo - pos) * sizeof(int));
+        ranking[lo] = playerId;
+    }
+}
+
 int *getPlayerOrder(game_state_t *state) {
     int n = state->num_jugadores;
     int *idOrder = malloc(sizeof(int) * n);
@@ -0,0 +1,228 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _GNU_SOURCE
+#include <spectate.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#define SPECTATE_CLOSE_TIMEOUT_S 1  // Espera máxima por espectador al vaciar las colas al cerrar
+
+// Mensaje de foto: encabezado, datos y tablero más grande posible
+static char snapshotMessage[sizeof(spectate_header_t) + sizeof(spectate_snapshot_t) + sizeof(int) * MAX_WIDTH * MAX_HEIGHT];
+
+static void copyRanking(unsigned char ranking[MAX_JUGADORES], const game_state_t *state) {
+    for (int i = 0; i < MAX_JUGADORES; i++) {
+        ranking[i] = (unsigned char)state->ranking[i];
+    }
+}
+
+// Arma el mensaje de foto del estado actual y devuelve su tamaño
+static size_t buildSnapshot(const spectators_t *spectators, const game_state_t *state) {
+    size_t cells = (size_t)state->width * state->height;
+    spectate_header_t *header = (spectate_header_t *)snapshotMessage;
+    spectate_snapshot_t *snapshot = (spectate_snapshot_t *)(header + 1);
+
+    header->type = SPECTATE_SNAPSHOT;
+    header->length = sizeof(*snapshot) + cells * sizeof(int);
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->game = spectators->game;
+    snapshot->width = state->width;
+    snapshot->height = state->height;
+    snapshot->num_jugadores = state->num_jugadores;
+    snapshot->terminado = state->terminado;
+    memcpy(snapshot->jugadores, state->jugadores, sizeof(snapshot->jugadores));
+    copyRanking(snapshot->ranking, state);
+    memcpy(snapshot + 1, state->tablero, cells * sizeof(int));
+    return sizeof(*header) + header->length;
+}
+
+static void dropClient(spectators_t *spectators, int slot) {
+    close(spectators->clients[slot]->fd);
+    free(spectators->clients[slot]);
+    spectators->clients[slot] = NULL;
+    spectators->dropped++;
+}
+
+// Encola un mensaje; si no entra, el espectador pasa a esperar una foto nueva
+static void enqueue(spectators_t *spectators, spectator_t *client, const void *data, size_t length) {
+    if (client->resync) return;
+    if (client->used + length > sizeof(client->buffer)) {
+        client->resync = 1;
+        spectators->resyncs++;
+        return;
+    }
+    memcpy(client->buffer + client->used, data, length);
+    client->used += length;
+}
+
+// Envía sin bloquear lo que se pueda; devuelve -1 si el espectador se desconectó
+static int flush(spectator_t *client) {
+    size_t sent = 0;
+    while (sent < client->used) {
+        ssize_t n = send(client->fd, client->buffer + sent, client->used - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return -1;
+        }
+        sent += n;
+    }
+    memmove(client->buffer, client->buffer + sent, client->used - sent);
+    client->used -= sent;
+    return 0;
+}
+
+// Vacía la cola de cada espectador y resincroniza a los que la terminaron de vaciar
+static void flushAll(spectators_t *spectators, const game_state_t *state) {
+    size_t snapshotLength = 0;
+    for (int i = 0; i < SPECTATE_MAX_CLIENTS; i++) {
+        spectator_t *client = spectators->clients[i];
+        if (client == NULL) continue;
+        if (flush(client) != 0) {
+            dropClient(spectators, i);
+            continue;
+        }
+        if (client->resync && client->used == 0) {
+            if (snapshotLength == 0) snapshotLength = buildSnapshot(spectators, state);
+            client->resync = 0;
+            enqueue(spectators, client, snapshotMessage, snapshotLength);
+            if (flush(client) != 0) dropClient(spectators, i);
+        }
+    }
+}
+
+// Acepta las conexiones pendientes; cada espectador nuevo arranca con una foto
+static void acceptClients(spectators_t *spectators) {
+    for (;;) {
+        int fd = accept4(spectators->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) return;
+
+        int slot = 0;
+        while (slot < SPECTATE_MAX_CLIENTS && spectators->clients[slot] != NULL) slot++;
+        spectator_t *client = slot < SPECTATE_MAX_CLIENTS ? malloc(sizeof(spectator_t)) : NULL;
+        if (client == NULL) {
+            close(fd);
+            continue;
+        }
+        client->fd = fd;
+        client->used = 0;
+        client->resync = 1;  // La foto sale en el próximo flushAll
+        spectators->clients[slot] = client;
+    }
+}
+
+int openSpectators(spectators_t *spectators, const char *path) {
+    memset(spectators, 0, sizeof(*spectators));
+    spectators->listen_fd = -1;
+    if (path == NULL) return 0;
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(address.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) return -1;
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) == -1 || listen(fd, SPECTATE_MAX_CLIENTS) == -1) {
+        int error = errno;
+        close(fd);
+        errno = error;
+        return -1;
+    }
+    spectators->listen_fd = fd;
+    strcpy(spectators->path, path);
+    return 0;
+}
+
+void spectateGame(spectators_t *spectators, const game_state_t *state, unsigned int game) {
+    if (spectators->listen_fd == -1) return;
+    spectators->game = game;
+    acceptClients(spectators);
+
+    // Los cambios de la partida anterior que sigan en cola ya no importan: todos esperan la foto
+    size_t length = buildSnapshot(spectators, state);
+    for (int i = 0; i < SPECTATE_MAX_CLIENTS; i++) {
+        spectator_t *client = spectators->clients[i];
+        if (client == NULL) continue;
+        client->resync = 0;
+        enqueue(spectators, client, snapshotMessage, length);
+    }
+    flushAll(spectators, state);
+}
+
+void spectateUpdate(spectators_t *spectators, const game_state_t *state, int playerId, int captured) {
+    if (spectators->listen_fd == -1) return;
+    acceptClients(spectators);
+
+    struct {
+        spectate_header_t header;
+        spectate_player_t update;
+    } message;
+    memset(&message, 0, sizeof(message));
+    message.header.type = SPECTATE_PLAYER;
+    message.header.length = sizeof(message.update);
+    message.update.player = (unsigned char)playerId;
+    message.update.captured = (unsigned char)captured;
+    copyRanking(message.update.ranking, state);
+    message.update.row = state->jugadores[playerId];
+
+    for (int i = 0; i < SPECTATE_MAX_CLIENTS; i++) {
+        if (spectators->clients[i] != NULL) enqueue(spectators, spectators->clients[i], &message, sizeof(message));
+    }
+    flushAll(spectators, state);
+}
+
+void spectateEnd(spectators_t *spectators, const game_state_t *state) {
+    if (spectators->listen_fd == -1) return;
+    acceptClients(spectators);
+
+    spectate_header_t header = {SPECTATE_END, 0};
+    for (int i = 0; i < SPECTATE_MAX_CLIENTS; i++) {
+        spectator_t *client = spectators->clients[i];
+        if (client == NULL) continue;
+        // Un espectador en resincronización recibe primero la foto final
+        if (client->resync && client->used == 0) {
+            client->resync = 0;
+            enqueue(spectators, client, snapshotMessage, buildSnapshot(spectators, state));
+        }
+        enqueue(spectators, client, &header, sizeof(header));
+    }
+    flushAll(spectators, state);
+}
+
+void closeSpectators(spectators_t *spectators) {
+    if (spectators->listen_fd == -1) return;
+
+    // Al cerrar sí se espera un poco, para que lo último de la sesión llegue a todos
+    struct timeval timeout = {SPECTATE_CLOSE_TIMEOUT_S, 0};
+    for (int i = 0; i < SPECTATE_MAX_CLIENTS; i++) {
+        spectator_t *client = spectators->clients[i];
+        if (client == NULL) continue;
+        fcntl(client->fd, F_SETFL, fcntl(client->fd, F_GETFL) & ~O_NONBLOCK);
+        setsockopt(client->fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        size_t sent = 0;
+        while (sent < client->used) {
+            ssize_t n = send(client->fd, client->buffer + sent, client->used - sent, MSG_NOSIGNAL);
+            if (n <= 0) break;
+            sent += n;
+        }
+        close(client->fd);
+        free(client);
+        spectators->clients[i] = NULL;
+    }
+    close(spectators->listen_fd);
+    unlink(spectators->path);
+    spectators->listen_fd = -1;
+}
@@ -0,0 +1,90 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+#define _DEFAULT_SOURCE
+#include <trace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+static int traceFd = -1;
+
+static unsigned long long monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Cada evento se escribe con un único write() sobre O_APPEND para que las
+// líneas de distintos procesos no se mezclen
+static void traceWrite(const char *line, int length) {
+    if (length > 0) {
+        write(traceFd, line, length);
+    }
+}
+
+void traceInit(const char *role) {
+    const char *path = getenv(TRACE_ENV);
+    if (path == NULL || traceFd != -1) return;
+
+    traceFd = open(path, O_WRONLY | O_APPEND | O_CLOEXEC);
+    if (traceFd == -1) return;
+
+    char comm[32] = "";
+    FILE *f = fopen("/proc/self/comm", "r");
+    if (f != NULL) {
+        if (fgets(comm, sizeof(comm), f) != NULL) {
+            comm[strcspn(comm, "\n")] = '\0';
+        }
+        fclose(f);
+    }
+
+    char line[160];
+    int length = snprintf(line, sizeof(line),
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s %s\"}},\n",
+        getpid(), role, comm);
+    traceWrite(line, length);
+}
+
+int traceEnabled() {
+    return traceFd != -1;
+}
+
+unsigned long long traceNow() {
+    return traceFd != -1 ? monotonicNs() : 0;
+}
+
+void traceSpan(const char *name, unsigned long long start) {
+    if (traceFd == -1) return;
+    unsigned long long end = monotonicNs();
+
+    char line[192];
+    int length = snprintf(line, sizeof(line),
+        "{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%ld},\n",
+        name, start / 1000.0, (end - start) / 1000.0, getpid(), (long)syscall(SYS_gettid));
+    traceWrite(line, length);
+}
+
+int traceCreate(const char *path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) return -1;
+    int ok = write(fd, "[\n", 2) == 2;
+    close(fd);
+    if (!ok) return -1;
+    return setenv(TRACE_ENV, path, 1);
+}
+
+void traceFinish() {
+    if (traceFd == -1) return;
+    // Evento final sin coma para que el arreglo sea JSON válido
+    char line[128];
+    int length = snprintf(line, sizeof(line),
+        "{\"name\":\"trace_end\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d}\n]\n",
+        monotonicNs() / 1000.0, getpid(), getpid());
+    traceWrite(line, length);
+    close(traceFd);
+    traceFd = -1;
+}
@@ -0,0 +1,414 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+
+/**
+ * @file tune.c
+ * @brief Ajuste de constantes de estrategias por autojuego
+ *
+ * Enfrenta a una estrategia con parámetros candidatos contra la misma
+ * estrategia con sus valores por defecto, en muchas partidas lockstep sin
+ * vista corridas en paralelo. La búsqueda es una estrategia evolutiva (1+1)
+ * con paso adaptativo (regla de 1/5): cada candidato es una perturbación
+ * gaussiana del mejor conocido y se acepta si junta una fracción mayor del
+ * puntaje. Todas las evaluaciones usan las mismas semillas, así que las
+ * comparaciones entre candidatos son pareadas.
+ *
+ * Cada máster corre con su propio CHOMP_SESSION para no compartir segmentos,
+ * y el candidato recibe sus parámetros como argumentos NOMBRE=valor.
+ *
+ * Se ejecuta desde el directorio de compilación, ya que lanza ./master y
+ * los binarios de players/.
+ *
+ * Uso: tune [-n iteraciones] [-g partidas] [-j procesos] [-w ancho] [-h alto]
+ *           [-s semilla] estrategia [oponente ...]
+ *
+ * @author Grupo 21
+ * @date 2025
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <session.h>
+
+#define DEFAULT_ITERATIONS 50
+#define DEFAULT_GAMES 100
+#define DEFAULT_SIZE 20
+#define MAX_JOBS 64
+#define MAX_OPPONENTS 7
+#define MAX_PARAMS 8
+#define CANDIDATE_NAME "candidate"
+#define INITIAL_SIGMA 0.25   // Paso inicial, como fracción del rango de cada parámetro
+
+/**
+ * @brief Parámetro ajustable de una estrategia
+ */
+typedef struct {
+    const char *name;  ///< Nombre que lee tuningParam
+    double min;        ///< Valor mínimo permitido
+    double max;        ///< Valor máximo permitido
+    double initial;    ///< Valor por defecto en el jugador
+    int integer;       ///< 1 si el jugador lo usa como entero
+} param_spec_t;
+
+/**
+ * @brief Estrategia ajustable y sus parámetros
+ */
+typedef struct {
+    const char *name;
+    int count;
+    param_spec_t params[MAX_PARAMS];
+} strategy_spec_t;
+
+static const strategy_spec_t strategies[] = {
+    {"planner", 4, {
+        {"BFS_DEPTH", 2, 20, 10, 1},
+        {"FREEDOM_BIAS", 0, 40, 10, 0},
+        {"SCORE_BIAS", 0, 20, 5, 0},
+        {"IMMEDIATE_FREEDOM_BIAS", 0, 1000, 441, 0},
+    }},
+    {"strategist", 4, {
+        {"HORIZON_DEPTH", 1, 12, 6, 1},
+        {"DECAY_FACTOR", 0.3, 0.99, 0.8, 0},
+        {"VORONOI_WEIGHT", 0, 2, 0.6, 0},
+        {"HORIZON_WEIGHT", 0, 2, 0.4, 0},
+    }},
+    {"enforcer", 1, {
+        {"CLOSE_THRESHOLD", 1, 20, 6, 1},
+    }},
+};
+
+/**
+ * @brief Configuración de una corrida del tuner
+ */
+typedef struct {
+    int iterations;
+    int games;
+    int jobs;
+    int width;
+    int height;
+    unsigned int seed;
+    int pin;                        ///< 1 para fijar cada máster y sus jugadores a una CPU
+    int cpus;                       ///< CPUs que el proceso puede usar, para repartir los másters
+    int cpu_ids[CPU_SETSIZE];       ///< Ids de esas CPUs, según sched_getaffinity
+    const char *boards;             ///< Archivo de tableros para todas las partidas (NULL = generarlos)
+    const strategy_spec_t *strategy;
+    char baseline_path[PATH_MAX];
+    char candidate_path[PATH_MAX];
+    const char *opponents[MAX_OPPONENTS];
+    int num_opponents;
+} tune_config_t;
+
+static void show_help(const char *program_name) {
+    fprintf(stderr, "Uso: %s [opciones] estrategia [oponente ...]\n", program_name);
+    fprintf(stderr, "Opciones:\n");
+    fprintf(stderr, "  -n iterations  Candidatos a evaluar (default: %d)\n", DEFAULT_ITERATIONS);
+    fprintf(stderr, "  -g games       Partidas por candidato (default: %d)\n", DEFAULT_GAMES);
+    fprintf(stderr, "  -j jobs        Másters en paralelo (default: CPUs disponibles)\n");
+    fprintf(stderr, "  -w width       Ancho del tablero (default: %d)\n", DEFAULT_SIZE);
+    fprintf(stderr, "  -h height      Alto del tablero (default: %d)\n", DEFAULT_SIZE);
+    fprintf(stderr, "  -s seed        Semilla de tableros y búsqueda (default: 1)\n");
+    fprintf(stderr, "  -a             Fijar cada máster y sus jugadores a una CPU distinta\n");
+    fprintf(stderr, "  -i file        Jugar los tableros de un archivo (ver -x del máster), sin -w ni -h\n");
+    fprintf(stderr, "Estrategias:");
+    for (size_t i = 0; i < sizeof(strategies) / sizeof(strategies[0]); i++) {
+        fprintf(stderr, " %s", strategies[i].name);
+    }
+    fprintf(stderr, "\n");
+}
+
+static int parse_arguments(int argc, char *argv[], tune_config_t *config) {
+    config->iterations = DEFAULT_ITERATIONS;
+    config->games = DEFAULT_GAMES;
+    // Solo las CPUs permitidas: bajo un cpuset los ids no van de 0 a n-1
+    cpu_set_t allowed;
+    config->cpus = 0;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &allowed)) config->cpu_ids[config->cpus++] = cpu;
+        }
+    }
+    if (config->cpus == 0) {
+        config->cpu_ids[0] = 0;
+        config->cpus = 1;
+    }
+    config->jobs = config->cpus;
+    config->pin = 0;
+    config->boards = NULL;
+    config->width = DEFAULT_SIZE;
+    config->height = DEFAULT_SIZE;
+    config->seed = 1;
+    config->num_opponents = 0;
+
+    int opt;
+    int size_given = 0;
+    while ((opt = getopt(argc, argv, "n:g:j:w:h:s:ai:")) != -1) {
+        switch (opt) {
+            case 'n': config->iterations = atoi(optarg); break;
+            case 'g': config->games = atoi(optarg); break;
+            case 'j': config->jobs = atoi(optarg); break;
+            case 'w': config->width = atoi(optarg); size_given = 1; break;
+            case 'h': config->height = atoi(optarg); size_given = 1; break;
+            case 's': config->seed = (unsigned int)atoi(optarg); break;
+            case 'a': config->pin = 1; break;
+            case 'i': config->boards = optarg; break;
+            default: return -1;
+        }
+    }
+    if (config->iterations < 1 || config->games < 1 || config->jobs < 1 || optind >= argc) {
+        return -1;
+    }
+    if (config->boards != NULL && size_given) {
+        fprintf(stderr, "Error: -w y -h no se pueden usar con -i, el tamaño sale del archivo de tableros\n");
+        return -1;
+    }
+    if (config->jobs > MAX_JOBS) config->jobs = MAX_JOBS;
+    if (config->jobs > config->games) config->jobs = config->games;
+
+    config->strategy = NULL;
+    for (size_t i = 0; i < sizeof(strategies) / sizeof(strategies[0]); i++) {
+        if (strcmp(argv[optind], strategies[i].name) == 0) config->strategy = &strategies[i];
+    }
+    if (config->strategy == NULL) {
+        fprintf(stderr, "Error: estrategia desconocida '%s'\n", argv[optind]);
+        return -1;
+    }
+    snprintf(config->baseline_path, sizeof(config->baseline_path), "players/%s", config->strategy->name);
+
+    for (optind++; optind < argc; optind++) {
+        if (config->num_opponents == MAX_OPPONENTS) {
+            fprintf(stderr, "Error: máximo %d oponentes\n", MAX_OPPONENTS);
+            return -1;
+        }
+        config->opponents[config->num_opponents++] = argv[optind];
+    }
+    return 0;
+}
+
+// Muestra de una normal estándar (Box-Muller)
+static double gaussian() {
+    double u = 1.0 - drand48();
+    double v = drand48();
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static void format_values(const strategy_spec_t *strategy, const double *values, char *out, size_t size, const char *prefix, const char *separator) {
+    size_t used = 0;
+    out[0] = '\0';
+    for (int i = 0; i < strategy->count && used < size; i++) {
+        const param_spec_t *param = &strategy->params[i];
+        if (param->integer) {
+            used += snprintf(out + used, size - used, "%s%s%s=%d", i ? separator : "", prefix, param->name, (int)values[i]);
+        } else {
+            used += snprintf(out + used, size - used, "%s%s%s=%.4g", i ? separator : "", prefix, param->name, values[i]);
+        }
+    }
+}
+
+// Lanza un máster con su propia sesión y devuelve el extremo de lectura de su salida
+static pid_t launch_master(const tune_config_t *config, const char *candidate_spec, int job, int games, unsigned int seed, int *out_fd) {
+    char games_arg[16], seed_arg[16], width_arg[16], height_arg[16], session[32], cpu_arg[16];
+    snprintf(games_arg, sizeof(games_arg), "%d", games);
+    snprintf(seed_arg, sizeof(seed_arg), "%u", seed);
+    snprintf(width_arg, sizeof(width_arg), "%d", config->width);
+    snprintf(height_arg, sizeof(height_arg), "%d", config->height);
+    snprintf(session, sizeof(session), "tune%d_%d", (int)getpid(), job);
+    snprintf(cpu_arg, sizeof(cpu_arg), "%d", config->cpu_ids[job % config->cpus]);
+
+    char *argv[24 + MAX_OPPONENTS];
+    int argc = 0;
+    argv[argc++] = "master";
+    argv[argc++] = "-l";
+    argv[argc++] = "-g"; argv[argc++] = games_arg;
+    argv[argc++] = "-s"; argv[argc++] = seed_arg;
+    if (config->boards == NULL) {
+        argv[argc++] = "-w"; argv[argc++] = width_arg;
+        argv[argc++] = "-h"; argv[argc++] = height_arg;
+    }
+    if (config->pin) {
+        // Una partida por CPU: el máster y sus jugadores se turnan, así que no compiten entre sí
+        argv[argc++] = "--pin-master"; argv[argc++] = cpu_arg;
+        argv[argc++] = "--pin-players"; argv[argc++] = cpu_arg;
+    }
+    if (config->boards != NULL) {
+        argv[argc++] = "-i"; argv[argc++] = (char *)config->boards;
+    }
+    argv[argc++] = "-p";
+    argv[argc++] = (char *)candidate_spec;
+    argv[argc++] = (char *)config->baseline_path;
+    for (int i = 0; i < config->num_opponents; i++) {
+        argv[argc++] = (char *)config->opponents[i];
+    }
+    argv[argc] = NULL;
+
+    int fds[2];
+    if (pipe(fds) == -1) {
+        perror("pipe");
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[1]);
+        setenv(SESSION_ENV, session, 1);
+        execv("./master", argv);
+        perror("execv master");
+        _exit(1);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        perror("fork");
+        close(fds[0]);
+        return -1;
+    }
+    *out_fd = fds[0];
+    return pid;
+}
+
+// Suma los puntajes de candidato y línea de base en las tablas de resultados del máster;
+// las demás tablas (como la de recursos) tienen filas con el mismo formato y se ignoran
+static void collect_scores(int fd, const char *baseline_name, unsigned long long *candidate, unsigned long long *baseline) {
+    FILE *out = fdopen(fd, "r");
+    if (!out) {
+        close(fd);
+        return;
+    }
+    char line[256];
+    int in_results = 0;
+    while (fgets(line, sizeof(line), out)) {
+        if (strstr(line, "===") != NULL) {
+            in_results = strstr(line, "=== Results ===") != NULL;
+            continue;
+        }
+        char name[64];
+        unsigned int score;
+        if (!in_results || sscanf(line, "| %63s | %u |", name, &score) != 2) continue;
+        if (strcmp(name, CANDIDATE_NAME) == 0) *candidate += score;
+        else if (strcmp(name, baseline_name) == 0) *baseline += score;
+    }
+    fclose(out);
+}
+
+/**
+ * @brief Juega todas las partidas de un candidato y mide su fracción del puntaje
+ *
+ * @return Puntaje del candidato sobre el de candidato + línea de base, o -1 si falló algún máster
+ */
+static double evaluate(const tune_config_t *config, const double *values) {
+    char params[512], candidate_spec[PATH_MAX + 512];
+    format_values(config->strategy, values, params, sizeof(params), "", " ");
+    snprintf(candidate_spec, sizeof(candidate_spec), "%s %s", config->candidate_path, params);
+
+    pid_t pids[MAX_JOBS];
+    int fds[MAX_JOBS];
+    int per_job = config->games / config->jobs;
+    int extra = config->games % config->jobs;
+    unsigned int seed = config->seed;
+    int launched = 0;
+
+    for (int j = 0; j < config->jobs; j++) {
+        int games = per_job + (j < extra ? 1 : 0);
+        pids[j] = launch_master(config, candidate_spec, j, games, seed, &fds[j]);
+        if (pids[j] < 0) break;
+        seed += games;
+        launched++;
+    }
+
+    unsigned long long candidate = 0, baseline = 0;
+    int failed = launched < config->jobs;
+    for (int j = 0; j < launched; j++) {
+        collect_scores(fds[j], config->strategy->name, &candidate, &baseline);
+        int status;
+        if (waitpid(pids[j], &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed = 1;
+        }
+    }
+    if (failed) return -1;
+    if (candidate + baseline == 0) return 0.5;
+    return (double)candidate / (double)(candidate + baseline);
+}
+
+// Perturba el mejor conocido respetando rangos y parámetros enteros
+static void mutate(const strategy_spec_t *strategy, const double *best, double sigma, double *out) {
+    for (int i = 0; i < strategy->count; i++) {
+        const param_spec_t *param = &strategy->params[i];
+        double value = best[i] + gaussian() * sigma * (param->max - param->min);
+        if (value < param->min) value = param->min;
+        if (value > param->max) value = param->max;
+        if (param->integer) value = round(value);
+        out[i] = value;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    tune_config_t config;
+    if (parse_arguments(argc, argv, &config) != 0) {
+        show_help(argv[0]);
+        return 1;
+    }
+    const strategy_spec_t *strategy = config.strategy;
+
+    // El candidato corre el mismo binario bajo otro nombre para distinguirlo en los resultados
+    char dir[] = "/tmp/chomptuneXXXXXX";
+    char target[PATH_MAX];
+    if (!mkdtemp(dir) || !realpath(config.baseline_path, target)) {
+        perror("tune");
+        return 1;
+    }
+    snprintf(config.candidate_path, sizeof(config.candidate_path), "%s/%s", dir, CANDIDATE_NAME);
+    if (symlink(target, config.candidate_path) == -1) {
+        perror("symlink");
+        rmdir(dir);
+        return 1;
+    }
+
+    srand48(config.seed);
+    double best[MAX_PARAMS], candidate[MAX_PARAMS];
+    for (int i = 0; i < strategy->count; i++) {
+        best[i] = strategy->params[i].initial;
+    }
+
+    char values[512];
+    double best_share = evaluate(&config, best);
+    if (best_share < 0) {
+        fprintf(stderr, "Error: falló la evaluación de los valores por defecto\n");
+        unlink(config.candidate_path);
+        rmdir(dir);
+        return 1;
+    }
+    format_values(strategy, best, values, sizeof(values), "", ",");
+    printf("iteration,share,sigma,accepted,params\n");
+    printf("0,%.4f,%.3f,1,%s\n", best_share, INITIAL_SIGMA, values);
+    fflush(stdout);
+
+    double sigma = INITIAL_SIGMA;
+    for (int it = 1; it <= config.iterations; it++) {
+        mutate(strategy, best, sigma, candidate);
+        double share = evaluate(&config, candidate);
+        int accepted = share > best_share;
+        if (accepted) {
+            memcpy(best, candidate, sizeof(best));
+            best_share = share;
+            sigma *= 1.5;
+        } else {
+            sigma *= 0.9;  // Con 1/5 de aceptaciones el paso queda estable
+        }
+        format_values(strategy, candidate, values, sizeof(values), "", ",");
+        printf("%d,%.4f,%.3f,%d,%s\n", it, share, sigma, accepted, values);
+        fflush(stdout);
+    }
+
+    format_values(strategy, best, values, sizeof(values), "CHOMP_", " ");
+    printf("# mejor (%.4f del puntaje): %s\n", best_share, values);
+
+    unlink(config.candidate_path);
+    rmdir(dir);
+    return 0;
+}
@@ -13,206 +13,102 @@
  * @date 2025
  */
 
+#define _DEFAULT_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <semaphore.h>
 #include <structs.h>
-#include <score.h>
+#include <render.h>
+#include <trace.h>
+#include <session.h>
 
-/**
- * @brief Códigos de color para salida de terminal
- * 
- * Arreglo de secuencias de escape ANSI para mostrar diferentes jugadores
- * en diferentes colores. Soporta hasta 9 jugadores (MAX_JUGADORES).
- */
-static const char* colors[] = {
-    "\033[34m",  // Azul
-    "\033[31m",  // Rojo
-    "\033[32m",  // Verde
-    "\033[33m",  // Amarillo
-    "\033[35m",  // Magenta
-    "\033[36m",  // Cian
-    "\033[37m",  // Blanco
-    "\033[90m",  // Gris Oscuro
-    "\033[93m"   // Amarillo Claro
-};
+// Modo de dibujo, como lista separada por espacios: "overview 80x24 follow=0 viewport=40"
+#define VIEW_ENV "CHOMP_VIEW"
+#define VIEW_DEFAULT_COLS 80
+#define VIEW_DEFAULT_ROWS 24
+#define VIEW_STATUS_LINES 6     // Título, separadores y barras alrededor del tablero
+#define VIEW_MIN_ROWS 4
 
-/**
- * @brief Imprime una barra de progreso animada para indicar que el juego está corriendo
- * 
- * Crea un indicador visual de que el juego está ejecutándose activamente mostrando
- * una barra con un carácter móvil que cicla a través de las posiciones.
- * 
- * @param length La longitud de la barra animada
- * @param frame El número de frame actual para la animación
- */
-void printAnimatedBar(int length, int frame) {
-    // Barra animada para mostrar que el juego sigue corriendo
-    int pos = ((frame % 10) + 10) % 10;
-    for (int i = 0; i < length; i++)
-    {
-        if (i%10 != pos) putchar('-');
-        else putchar('|');
-        putchar(' ');
-    }
-    putchar('\n');
-}
+#define VIEW_AUTO 0             // Vista general solo si el tablero no entra en la terminal
+#define VIEW_FULL 1             // Siempre el tablero completo
+#define VIEW_OVERVIEW 2         // Siempre la vista general
 
 /**
- * @brief Imprime una barra decorativa para la pantalla de fin de juego
- * 
- * Crea una barra separadora visual usando signos iguales para la pantalla final del juego.
- * 
- * @param length La longitud de la barra a imprimir
+ * @brief Configuración de dibujo leída de CHOMP_VIEW
  */
-void printEndgameBar(int length) {
-    for (int i = 0; i < length-1; i++)
-    {
-        printf("==");
-    }
-    printf("=\n");
-}
+typedef struct {
+    int mode;               ///< VIEW_AUTO, VIEW_FULL o VIEW_OVERVIEW
+    int cols;               ///< Columnas pedidas, 0 para usar las de la terminal
+    int rows;               ///< Filas pedidas, 0 para usar las de la terminal
+    int follow;             ///< Jugador a seguir, -1 para ninguno
+    int viewport;           ///< Lado de la ventana que sigue al jugador
+} view_settings_t;
 
 /**
- * @brief Dibuja el tablero de juego con posiciones actuales de jugadores y celdas visitadas
+ * @brief Lee la configuración de dibujo del entorno
  * 
- * Renderiza el tablero de juego mostrando:
- * - Posiciones actuales de jugadores como letras coloreadas (A, B, C, etc.)
- * - Celdas previamente visitadas como puntos coloreados
- * - Celdas no visitadas como sus valores numéricos
+ * La vista se lanza sin argumentos, así que las opciones llegan por
+ * CHOMP_VIEW como el resto de la configuración de la sesión.
  * 
- * @param state Puntero al estado actual del juego
+ * @param settings Donde se guarda la configuración
  */
-void drawBoard(game_state_t *state) {
-    if (!state || state->width <= 0 || state->height <= 0) {
-        printf("Error: Estado de juego inválido o dimensiones incorrectas\n");
-        return;
-    }
-    
-    for (int y=0; y<state->height; y++) {
-        for (int x=0; x<state->width; x++) {
-            int val = state->tablero[y * state->width + x];
-            
-            // Verificar si hay un jugador en esta posición actual
-            int current_player = -1;
-            for (size_t i = 0; i < state->num_jugadores; i++) {
-                if (state->jugadores[i].x == x && state->jugadores[i].y == y) {
-                    current_player = i;
-                    break;
-                }
-            }
-            
-            if (current_player != -1) {
-                // Posición actual de un jugador: mostrar letra coloreada
-                char player_char = 'A' + current_player;
-                if (current_player < 9) {
-                    printf("%s%c\033[0m ", colors[current_player], player_char);
-                } else {
-                    printf("%c ", player_char);  // Fallabck para índice de jugador inválido
-                }
-            } else if (val <= 0) {
-                // Posiciones visitadas: 0 para jugador 0, -i para jugador i
-                int player_id = -val;
-                
-                if (player_id < 9) {
-                    printf("%s.\033[0m ", colors[player_id]);
-                } else {
-                    printf(". ");  // Fallback
-                }
-            } else {
-                // Casilleros no visitados: mostrar valores (incluye 0)
-                printf("%d ", val);
-            }
+void loadViewSettings(view_settings_t *settings) {
+    *settings = (view_settings_t){VIEW_AUTO, 0, 0, -1, 0};
+    const char *value = getenv(VIEW_ENV);
+    if (value == NULL) return;
+
+    char copy[128];
+    snprintf(copy, sizeof(copy), "%s", value);
+    char *saveptr = NULL;
+    for (char *token = strtok_r(copy, " ,", &saveptr); token != NULL; token = strtok_r(NULL, " ,", &saveptr)) {
+        int cols, rows;
+        if (strcmp(token, "full") == 0) settings->mode = VIEW_FULL;
+        else if (strcmp(token, "overview") == 0) settings->mode = VIEW_OVERVIEW;
+        else if (strcmp(token, "auto") == 0) settings->mode = VIEW_AUTO;
+        else if (strncmp(token, "follow=", 7) == 0) settings->follow = atoi(token + 7);
+        else if (strncmp(token, "viewport=", 9) == 0) settings->viewport = atoi(token + 9);
+        else if (sscanf(token, "%dx%d", &cols, &rows) == 2 && cols > 0 && rows > 0) {
+            settings->cols = cols;
+            settings->rows = rows;
         }
-        putchar('\n');
     }
 }
 
 /**
- * @brief Imprime el estado actual del juego y la tabla de posiciones
- * 
- * Muestra una tabla de posiciones formateada con todos los jugadores ordenados por puntaje,
- * incluyendo sus nombres, puntajes, posiciones y estado de bloqueo.
+ * @brief Decide cómo dibujar el tablero en este cuadro
  * 
- * @param state Puntero al estado actual del juego
- * @param title Título a mostrar encima de la tabla de posiciones
+ * @param state Estado del juego
+ * @param settings Configuración de dibujo
+ * @param overview Donde se arma la vista general si corresponde
+ * @return overview si hay que usar la vista general, NULL para el tablero completo
  */
-void printStatus(game_state_t *state, char *title) {
-    if (!state || !title) {
-        printf("Error: Parámetros inválidos para printStatus\n");
-        return;
+const overview_t *chooseOverview(game_state_t *state, const view_settings_t *settings, overview_t *overview) {
+    if (settings->mode == VIEW_FULL) return NULL;
+
+    struct winsize terminal;
+    int isTerminal = ioctl(STDOUT_FILENO, TIOCGWINSZ, &terminal) == 0 && terminal.ws_col > 0;
+    int cols = settings->cols ? settings->cols : (isTerminal ? terminal.ws_col : VIEW_DEFAULT_COLS);
+    int rows = settings->rows ? settings->rows
+             : (isTerminal ? terminal.ws_row : VIEW_DEFAULT_ROWS) - (int)state->num_jugadores - VIEW_STATUS_LINES;
+    if (rows < VIEW_MIN_ROWS) rows = VIEW_MIN_ROWS;
+
+    // En automático solo se reduce si el tablero completo no entra en la terminal
+    if (settings->mode == VIEW_AUTO && settings->follow < 0
+        && (!isTerminal || (state->width * 2 <= cols && state->height <= rows))) {
+        return NULL;
     }
-    
-    printf("\n%28s\n", title);
-    jugador_t *players = state->jugadores;
-    int *idOrder = getPlayerOrder(state);
-    if (!idOrder) return;
 
-    for (size_t i = 0; i < state->num_jugadores; i++) {
-        int id = idOrder[i];
-        printf("%s%-16s\033[0m | %4u p | (%2d,%2d) |",
-                (id < 9) ? colors[id] : "",
-                players[id].nombre,
-                players[id].puntaje,
-                players[id].x,
-                players[id].y);
-        if (players[id].stuck) {
-            printf(" %s(x_x)\033[0m", (id < 9) ? colors[id] : "");
-        }
-        putchar('\n');
-    }
-    free(idOrder);
-}
-
-/**
- * @brief Muestra el estado final del juego y el ganador
- * 
- * Muestra la tabla de posiciones final, el tablero de juego, y anuncia el ganador
- * con el puntaje más alto.
- * 
- * @param state Puntero al estado actual del juego
- */
-void gameEnded(game_state_t *state) {
-    if (!state) {
-        printf("Error: Estado de juego inválido para gameEnded\n");
-        return;
-    }
-    
-    printStatus(state, "=== Game over ===");
-    putchar('\n');
-
-    printEndgameBar(state->width);
-    drawBoard(state);
-    printEndgameBar(state->width);
-    
-    size_t winners[state->num_jugadores];
-    size_t winnerCount = 0;
-    winners[0] = 0;
-
-    for (size_t i=0; i < state->num_jugadores; i++) {
-        jugador_t p = state->jugadores[i];
-        int cmp = comparePlayers(p,state->jugadores[winners[0]]);
-        if (cmp > 0) {
-            winners[0] = i;
-            winnerCount = 1;
-        }
-        else if (cmp == 0) {
-            winners[winnerCount++] = i;
-        }
-    }
-
-    printf("\n=== Winner%s: [ ", winnerCount > 1 ? "s" : "");
-    for (size_t i = 0; i < winnerCount; i++) {
-        int idx = winners[i];
-        char *color = idx < 9 ? colors[idx] : "";
-        printf("%s%s\033[0m", color, state->jugadores[idx].nombre);
-        if (i < winnerCount-1) printf(", ");
-    }
-    printf(" ] ===\n");
+    overview->cols = cols;
+    overview->rows = rows;
+    overview->follow = settings->follow;
+    overview->viewport = settings->viewport > 0 ? settings->viewport : (cols < rows * 2 ? cols : rows * 2);
+    return overview;
 }
 
 /**
@@ -224,17 +120,19 @@ void gameEnded(game_state_t *state) {
  * @return 0 en caso de éxito, 1 en caso de error
  */
 int main() {
+    char shm_name[SHM_NAME_LENGTH];
+
     // Abrir memoria compartida para el estado del juego (solo lectura)
-    int shm_state_fd = shm_open("/game_state", O_RDONLY, 0);
+    int shm_state_fd = shm_open(sessionShmName("/game_state", shm_name), O_RDONLY, 0);
     if (shm_state_fd == -1) {
         perror("shm_open game_state");
         return 1;
     }
     
     // Mapear el estado del juego en memoria
-    game_state_t *state = mmap(NULL, sizeof(game_state_t),
-                               PROT_READ, MAP_SHARED,
-                               shm_state_fd, 0);
+    int options = sessionShmOptions();
+    size_t state_size = sessionShmSize(sizeof(game_state_t), options);
+    game_state_t *state = mapSessionSegment(shm_state_fd, state_size, PROT_READ, options);
     if (state == MAP_FAILED) {
         perror("mmap game_state");
         close(shm_state_fd);
@@ -242,52 +140,66 @@ int main() {
     }
 
     // Abrir memoria compartida para sincronización (lectura-escritura)
-    int shm_sync_fd = shm_open("/game_sync", O_RDWR, 0);
+    int shm_sync_fd = shm_open(sessionShmName("/game_sync", shm_name), O_RDWR, 0);
     if (shm_sync_fd == -1) {
         perror("shm_open game_sync");
-        munmap(state, sizeof(game_state_t));
+        munmap(state, state_size);
         close(shm_state_fd);
         return 1;
     }
     
     // Mapear la estructura de sincronización en memoria
-    game_sync_t *sync = mmap(NULL, sizeof(game_sync_t),
-                             PROT_READ | PROT_WRITE, MAP_SHARED,
-                             shm_sync_fd, 0);
+    game_sync_t *sync = mapSessionSegment(shm_sync_fd, sizeof(game_sync_t),
+                                          PROT_READ | PROT_WRITE, options & ~SHM_HUGEPAGES);
     if (sync == MAP_FAILED) {
         perror("mmap game_sync");
         close(shm_sync_fd);
-        munmap(state, sizeof(game_state_t));
+        munmap(state, state_size);
         close(shm_state_fd);
         return 1;
     }
 
     fflush(stdout);
+    traceInit("vista");
 
     int frameCounter = 0;
+    view_settings_t settings;
+    overview_t overviewBuffer;
+    loadViewSettings(&settings);
 
     // Bucle principal del juego - esperar actualizaciones del master y mostrar
     while (1) {
         sem_wait(&sync->view_update_signal);
 
-        if (state->terminado) break;
+        if (state->terminado) {
+            if (!sync->more_games) break;
+            // Sesión de varias partidas: mostrar el resultado y esperar la siguiente
+            gameEnded(state, chooseOverview(state, &settings, &overviewBuffer));
+            sem_post(&sync->view_done_signal);
+            continue;
+        }
+        unsigned long long frameStart = traceNow();
+        const overview_t *overview = chooseOverview(state, &settings, &overviewBuffer);
+        int barLength = overview ? (overviewColumns(state, overview) + 1) / 2 : state->width;
         printStatus(state, "=== Leaderboard ===");
         putchar('\n');
         
-        printAnimatedBar(state->width, -1 - frameCounter);
-        drawBoard(state);
-        printAnimatedBar(state->width, frameCounter++);
+        printAnimatedBar(barLength, -1 - frameCounter);
+        if (overview) drawOverview(state, overview);
+        else drawBoard(state);
+        printAnimatedBar(barLength, frameCounter++);
         fflush(stdout);
+        traceSpan("frame", frameStart);
 
         sem_post(&sync->view_done_signal);
     }
     
     // El juego ha terminado - mostrar estado final
-    gameEnded(state);
+    gameEnded(state, chooseOverview(state, &settings, &overviewBuffer));
     sem_post(&sync->view_done_signal);
 
     // Limpiar recursos
-    munmap(state, sizeof(game_state_t));
+    munmap(state, state_size);
     munmap(sync, sizeof(game_sync_t));
     close(shm_state_fd);
     close(shm_sync_fd);